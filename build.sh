@@ -2,10 +2,11 @@
 
 CFLAGS="$CFLAGS -DBUILD_LINUX -O0 -g3 -ggdb -ffunction-sections -fdata-sections -Wl,--gc-sections"
 WFLAGS="$WFLAGS -Wall -Wextra -Wno-unused-function -Wno-unused-variable -Wno-unused-parameter -Wshadow -Wundef"
-LFLAGS="$LFLAGS -lX11 -lGL -lm"
+LFLAGS="$LFLAGS -lX11 -lGL -lm -lpthread"
 
 set -e
 
 gcc nix_text.c -o text $CFLAGS $WFLAGS $LFLAGS
+gcc headless_text.c -o text_headless $CFLAGS -DBUILD_HEADLESS $WFLAGS -lm -lpthread
 
 echo "Success"
\ No newline at end of file
@@ -1,8 +1,31 @@
 #include <stdint.h>
+#include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
 
 #define PI_F32   3.14159265358979323846264338327950288f
 
+#if defined(BUILD_HEADLESS)
+#define GFX_GL 0
+#else
+#define GFX_GL 1
+#endif
+
+#if defined(BUILD_TRACE)
+#define GFX_TRACE 1
+#else
+#define GFX_TRACE 0
+#endif
+
+#if defined(BUILD_SCALAR)
+#define GFX_SIMD 0
+#else
+#define GFX_SIMD 1
+#endif
+
 #ifndef GL_BGR
 #define GL_BGR 0x80E0
 #endif
@@ -43,17 +66,47 @@ typedef struct
     i8* At;
 } gfx_str;
 
+#define GFX_FNT_CODES 0x110000
+#define GFX_FNT_BLOCKS (GFX_FNT_CODES >> 8)
+#define GFX_FNT_SLOTS 0xFFFF
+
 typedef struct
 {
-    u32 Cols;
+    u32 Cols; // Drawn glyph size
     u32 Rows;
+    u32 Width; // Glyph bitmap size
+    u32 Height;
     u32 Skip;
     u32 Jump;
     u32 Size;
-    u8* Data;
+    u8* Data; // 1-bit glyph bitmaps, Skip bytes per row, MSB first
+    u32 Count;
+    u32 Capacity; // Glyph slots of the Codes and Data block, when it is allocated rather than mapped
+    u32* Codes; // Codepoint of every glyph slot
+    u32 Default;
+    u16* Dir; // Page of every 256 codepoints block, page 0 is all default
+    u16* Pages; // Glyph slot of every codepoint in a page
+    u32 PageCount;
     u32 Texture;
+    u32 TexSize;
+    u32 TexCols; // Glyphs per atlas row
+    u32 TexRows; // Glyphs per atlas column
+    f32* Uvs; // Atlas rect of every glyph slot, U1 V1 U2 V2
+    f32 White[2]; // Center of the solid cell after the last glyph
+    void* Map;
+    usz MapSize;
 } gfx_fnt;
 
+typedef void gfx_thread_proc(void* Param);
+
+typedef struct
+{
+    u64 Dev; // Device and inode, or volume serial and file index, which tell files apart
+    u64 Ino;
+    u64 Size;
+    u64 Time;
+} gfx_stamp;
+
 #if defined(BUILD_WIN32)
 
 //
@@ -62,8 +115,23 @@ typedef struct
 
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+// NOTE: For _BitScanForward64 and __rdtsc, SIMD code stays under GFX_SIMD
+#include <intrin.h>
 #include <GL/gl.h>
 
+// NOTE: glcorearb.h includes KHR/khrplatform.h, which Windows SDK does not ship
+#define __khrplatform_h_
+typedef float khronos_float_t;
+typedef int8_t khronos_int8_t;
+typedef uint8_t khronos_uint8_t;
+typedef int16_t khronos_int16_t;
+typedef uint16_t khronos_uint16_t;
+typedef int64_t khronos_int64_t;
+typedef uint64_t khronos_uint64_t;
+typedef intptr_t khronos_intptr_t;
+typedef intptr_t khronos_ssize_t;
+#include "glcorearb.h"
+
 #define gfxGlGetProcAddress(Name) wglGetProcAddress(Name)
 
 static void* gfxVirtualAlloc(usz Size)
@@ -76,6 +144,21 @@ static void gfxVirtualFree(void* Data)
     VirtualFree(Data, 0, MEM_DECOMMIT|MEM_RELEASE);
 }
 
+static void* gfxVirtualReserve(usz Size)
+{
+    return VirtualAlloc(0, Size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+static b32 gfxVirtualCommit(void* Data, usz Size)
+{
+    return VirtualAlloc(Data, Size, MEM_COMMIT, PAGE_READWRITE) != 0;
+}
+
+static void gfxVirtualRelease(void* Data, usz Size)
+{
+    VirtualFree(Data, 0, MEM_RELEASE);
+}
+
 static void* gfxLoadFile(const char* Name, usz* Size)
 {
     void* Result = 0;
@@ -113,11 +196,301 @@ static void* gfxLoadFile(const char* Name, usz* Size)
     return Result;
 }
 
+// NOTE: Files may still be open for writing by others, who may also rename or delete them
+static void* gfxMapFile(const char* Name, usz* Size)
+{
+    void* Result = 0;
+
+    DWORD Share = FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE;
+    HANDLE Handle = CreateFileA(Name, GENERIC_READ, Share, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if(Handle != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER LargeInteger;
+        if(GetFileSizeEx(Handle, &LargeInteger) && LargeInteger.QuadPart)
+        {
+            HANDLE Mapping = CreateFileMappingA(Handle, 0, PAGE_READONLY, 0, 0, 0);
+            if(Mapping)
+            {
+                Result = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+                if(Result)
+                {
+                    *Size = (usz) LargeInteger.QuadPart;
+                }
+
+                CloseHandle(Mapping);
+            }
+        }
+
+        CloseHandle(Handle);
+    }
+
+    return Result;
+}
+
+static void gfxUnmapFile(void* Data, usz Size)
+{
+    UnmapViewOfFile(Data);
+}
+
+// NOTE: Written aside and moved over the file, so other processes that have it mapped keep the old contents
+static b32 gfxSaveFile(const char* Name, const void* Data, usz Size)
+{
+    b32 Result = 0;
+
+    char Temp[MAX_PATH];
+    int Length = snprintf(Temp, sizeof(Temp), "%s.%lu.tmp", Name, GetCurrentProcessId());
+    if(Length > 0 && Length < (int)sizeof(Temp))
+    {
+        HANDLE Handle = CreateFileA(Temp, GENERIC_WRITE, 0, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+        if(Handle != INVALID_HANDLE_VALUE)
+        {
+            DWORD Written = 0;
+            b32 Complete = Size <= 0xFFFFFFFF && WriteFile(Handle, Data, (DWORD)Size, &Written, 0) && Written == Size;
+
+            CloseHandle(Handle);
+
+            if(Complete && MoveFileExA(Temp, Name, MOVEFILE_REPLACE_EXISTING))
+            {
+                Result = 1;
+            }
+            else
+            {
+                DeleteFileA(Temp);
+            }
+        }
+    }
+
+    return Result;
+}
+
+static b32 gfxFileStamp(const char* Name, u64* Size, u64* Time)
+{
+    b32 Result = 0;
+
+    WIN32_FILE_ATTRIBUTE_DATA Data;
+    if(GetFileAttributesExA(Name, GetFileExInfoStandard, &Data))
+    {
+        *Size = ((u64)Data.nFileSizeHigh << 32) | Data.nFileSizeLow;
+        *Time = ((u64)Data.ftLastWriteTime.dwHighDateTime << 32) | Data.ftLastWriteTime.dwLowDateTime;
+        Result = 1;
+    }
+
+    return Result;
+}
+
+// NOTE: Reads up to *Size bytes at Offset and leaves in *Size how many were read, Stamp is of the same file
+static b32 gfxReadFileAt(const char* Name, u64 Offset, void* Data, usz* Size, gfx_stamp* Stamp)
+{
+    b32 Result = 0;
+
+    DWORD Share = FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE;
+    HANDLE Handle = CreateFileA(Name, GENERIC_READ, Share, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if(Handle != INVALID_HANDLE_VALUE)
+    {
+        BY_HANDLE_FILE_INFORMATION Info;
+        if(GetFileInformationByHandle(Handle, &Info))
+        {
+            Stamp->Dev = Info.dwVolumeSerialNumber;
+            Stamp->Ino = ((u64)Info.nFileIndexHigh << 32) | Info.nFileIndexLow;
+            Stamp->Size = ((u64)Info.nFileSizeHigh << 32) | Info.nFileSizeLow;
+            Stamp->Time = ((u64)Info.ftLastWriteTime.dwHighDateTime << 32) | Info.ftLastWriteTime.dwLowDateTime;
+
+            usz Read = 0;
+            LARGE_INTEGER Position;
+            Position.QuadPart = (LONGLONG) Offset;
+            if(SetFilePointerEx(Handle, Position, 0, FILE_BEGIN))
+            {
+                while(Read < *Size)
+                {
+                    DWORD Count = 0;
+                    DWORD Want = (DWORD) Min(*Size - Read, (usz)0x40000000);
+                    if(!ReadFile(Handle, (u8*)Data + Read, Want, &Count, 0) || !Count)
+                    {
+                        break;
+                    }
+
+                    Read += Count;
+                }
+            }
+
+            *Size = Read;
+            Result = 1;
+        }
+
+        CloseHandle(Handle);
+    }
+
+    return Result;
+}
+
 static void gfxDebugPrint(const char* String)
 {
     OutputDebugStringA(String);
 }
 
+// NOTE: Windows has no watch of a single file, so the directory of it is watched for size and time changes
+typedef struct
+{
+    HANDLE Handle;
+} gfx_watch;
+
+static b32 gfxWatchOpen(gfx_watch* Watch, const char* Name)
+{
+    char Dir[MAX_PATH];
+    usz Length = 0;
+    for(usz Idx = 0; Name[Idx] && Idx < sizeof(Dir); Idx++)
+    {
+        if(Name[Idx] == '\\' || Name[Idx] == '/')
+        {
+            Length = Idx;
+        }
+    }
+
+    if(Length)
+    {
+        memcpy(Dir, Name, Length);
+        Dir[Length] = 0;
+    }
+    else
+    {
+        Dir[0] = '.';
+        Dir[1] = 0;
+    }
+
+    Watch->Handle = FindFirstChangeNotificationA(Dir, FALSE, FILE_NOTIFY_CHANGE_SIZE|FILE_NOTIFY_CHANGE_LAST_WRITE|FILE_NOTIFY_CHANGE_FILE_NAME);
+    return Watch->Handle != INVALID_HANDLE_VALUE;
+}
+
+// NOTE: Returns 1 when something may have changed since the last poll
+static b32 gfxWatchPoll(gfx_watch* Watch)
+{
+    b32 Result = 0;
+
+    if(WaitForSingleObject(Watch->Handle, 0) == WAIT_OBJECT_0)
+    {
+        FindNextChangeNotification(Watch->Handle);
+        Result = 1;
+    }
+
+    return Result;
+}
+
+static void gfxWatchClose(gfx_watch* Watch)
+{
+    FindCloseChangeNotification(Watch->Handle);
+}
+
+typedef struct
+{
+    gfx_thread_proc* Proc;
+    void* Param;
+    HANDLE Handle;
+} gfx_thread;
+
+typedef HANDLE gfx_sem;
+
+static DWORD WINAPI gfxThreadMain(LPVOID Param)
+{
+    gfx_thread* Thread = (gfx_thread*) Param;
+    Thread->Proc(Thread->Param);
+    return 0;
+}
+
+static b32 gfxThreadStart(gfx_thread* Thread)
+{
+    Thread->Handle = CreateThread(0, 0, gfxThreadMain, Thread, 0, 0);
+    return Thread->Handle != 0;
+}
+
+static void gfxThreadJoin(gfx_thread* Thread)
+{
+    WaitForSingleObject(Thread->Handle, INFINITE);
+    CloseHandle(Thread->Handle);
+}
+
+static b32 gfxSemInit(gfx_sem* Sem)
+{
+    *Sem = CreateSemaphoreA(0, 0, 0x7FFFFFFF, 0);
+    return *Sem != 0;
+}
+
+static void gfxSemWait(gfx_sem* Sem)
+{
+    WaitForSingleObject(*Sem, INFINITE);
+}
+
+static void gfxSemPost(gfx_sem* Sem, u32 Count)
+{
+    ReleaseSemaphore(*Sem, Count, 0);
+}
+
+static void gfxSemFree(gfx_sem* Sem)
+{
+    CloseHandle(*Sem);
+}
+
+static u32 gfxAtomicInc(volatile u32* Value)
+{
+    return (u32) InterlockedIncrement((volatile LONG*) Value) - 1;
+}
+
+// NOTE: x64 loads are not reordered with later loads, only the compiler has to be stopped
+static u32 gfxAtomicLoad(volatile u32* Value)
+{
+    u32 Result = *Value;
+    _ReadWriteBarrier();
+    return Result;
+}
+
+static void gfxAtomicStore(volatile u32* Value, u32 New)
+{
+    InterlockedExchange((volatile LONG*) Value, (LONG) New);
+}
+
+static u32 gfxBitScan(u64 Value)
+{
+    unsigned long Index;
+    _BitScanForward64(&Index, Value);
+    return (u32) Index;
+}
+
+// NOTE: __popcnt64 needs a CPU with POPCNT, which x64 does not guarantee
+static u32 gfxBitCount(u64 Value)
+{
+    Value = Value - ((Value >> 1) & 0x5555555555555555ull);
+    Value = (Value & 0x3333333333333333ull) + ((Value >> 2) & 0x3333333333333333ull);
+    Value = (Value + (Value >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (u32) ((Value * 0x0101010101010101ull) >> 56);
+}
+
+static u64 gfxTsc(void)
+{
+    return __rdtsc();
+}
+
+#define GFX_THREAD_LOCAL __declspec(thread)
+
+static u32 gfxCpuCount(void)
+{
+    SYSTEM_INFO Info;
+    GetSystemInfo(&Info);
+    return Info.dwNumberOfProcessors;
+}
+
+static u64 gfxClock(void)
+{
+    static LARGE_INTEGER Frequency;
+    if(!Frequency.QuadPart)
+    {
+        QueryPerformanceFrequency(&Frequency);
+    }
+
+    LARGE_INTEGER Counter;
+    QueryPerformanceCounter(&Counter);
+    return (u64) ((Counter.QuadPart / Frequency.QuadPart) * 1000000000ull +
+                  (Counter.QuadPart % Frequency.QuadPart) * 1000000000ull / Frequency.QuadPart);
+}
+
 #elif defined(BUILD_LINUX)
 
 //
@@ -129,10 +502,17 @@ static void gfxDebugPrint(const char* String)
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
-#include <stdlib.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/inotify.h>
+#include <time.h>
+
+#if GFX_GL
 #include <GL/glx.h>
+#include "glcorearb.h"
 
 #define gfxGlGetProcAddress(Name) glXGetProcAddress((const GLubyte*) (Name))
+#endif
 
 static void* gfxVirtualAlloc(usz Size)
 {
@@ -144,6 +524,22 @@ static void gfxVirtualFree(void* Data)
     free(Data);
 }
 
+static void* gfxVirtualReserve(usz Size)
+{
+    void* Result = mmap(0, Size, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE, -1, 0);
+    return (Result == MAP_FAILED) ? 0 : Result;
+}
+
+static b32 gfxVirtualCommit(void* Data, usz Size)
+{
+    return mprotect(Data, Size, PROT_READ|PROT_WRITE) == 0;
+}
+
+static void gfxVirtualRelease(void* Data, usz Size)
+{
+    munmap(Data, Size);
+}
+
 static void* gfxLoadFile(const char* Name, usz* Size)
 {
     void* Result = 0;
@@ -190,1095 +586,5984 @@ static void* gfxLoadFile(const char* Name, usz* Size)
     return Result;
 }
 
-static void gfxDebugPrint(const char* String)
+static void* gfxMapFile(const char* Name, usz* Size)
 {
-    fputs(String, stdout);
+    void* Result = 0;
+
+    int Fd = open(Name, O_RDONLY);
+    if(Fd != -1)
+    {
+        struct stat Stat;
+        if(fstat(Fd, &Stat) == 0 && Stat.st_size > 0)
+        {
+            void* Data = mmap(0, Stat.st_size, PROT_READ, MAP_PRIVATE, Fd, 0);
+            if(Data != MAP_FAILED)
+            {
+                *Size = Stat.st_size;
+                Result = Data;
+            }
+            else
+            {
+                // TODO: Logging
+            }
+        }
+
+        close(Fd);
+    }
+
+    return Result;
 }
 
-#endif
+static void gfxUnmapFile(void* Data, usz Size)
+{
+    munmap(Data, Size);
+}
 
-static void gfxError(const char* Format, ...)
+// NOTE: Written aside and renamed over the file, so other processes that have it mapped keep the old inode
+static b32 gfxSaveFile(const char* Name, const void* Data, usz Size)
 {
-    char String[1024];
+    b32 Result = 0;
 
-    va_list VaList;
-    va_start(VaList, Format);
-    vsnprintf(String, sizeof(String), Format, VaList);
-    va_end(VaList);
+    char Temp[4096];
+    int Length = snprintf(Temp, sizeof(Temp), "%s.%d.tmp", Name, (int)getpid());
+    if(Length > 0 && Length < (int)sizeof(Temp))
+    {
+        int Fd = open(Temp, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+        if(Fd != -1)
+        {
+            ssize_t Count = write(Fd, Data, Size);
+            b32 Complete = Count == (ssize_t)Size;
 
-    gfxDebugPrint(String);
+            close(Fd);
 
-    Assert(0);
+            if(Complete && rename(Temp, Name) == 0)
+            {
+                Result = 1;
+            }
+            else
+            {
+                unlink(Temp);
+            }
+        }
+    }
+
+    return Result;
 }
 
-static void gfxDebug(const char* Format, ...)
+static b32 gfxFileStamp(const char* Name, u64* Size, u64* Time)
 {
-    char String[1024];
+    b32 Result = 0;
 
-    va_list VaList;
-    va_start(VaList, Format);
-    vsnprintf(String, sizeof(String), Format, VaList);
-    va_end(VaList);
+    struct stat Stat;
+    if(stat(Name, &Stat) == 0)
+    {
+        *Size = Stat.st_size;
+        *Time = (u64)Stat.st_mtim.tv_sec * 1000000000ull + Stat.st_mtim.tv_nsec;
+        Result = 1;
+    }
 
-    gfxDebugPrint(String);
+    return Result;
 }
 
-#define GL_DEBUG_TYPE_ERROR               0x824C
-
-static void gfxGlCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const char* message, const void* userParam)
+// NOTE: Reads up to *Size bytes at Offset and leaves in *Size how many were read, Stamp is of the same file
+static b32 gfxReadFileAt(const char* Name, u64 Offset, void* Data, usz* Size, gfx_stamp* Stamp)
 {
-    gfxError( "GL CALLBACK: %s type = 0x%x, severity = 0x%x, message = %s\n",
-           ( type == GL_DEBUG_TYPE_ERROR ? "** GL ERROR **" : "" ),
-            type, severity, message );
+    b32 Result = 0;
+
+    int Fd = open(Name, O_RDONLY);
+    if(Fd != -1)
+    {
+        struct stat Stat;
+        if(fstat(Fd, &Stat) == 0)
+        {
+            Stamp->Dev = Stat.st_dev;
+            Stamp->Ino = Stat.st_ino;
+            Stamp->Size = Stat.st_size;
+            Stamp->Time = (u64)Stat.st_mtim.tv_sec * 1000000000ull + Stat.st_mtim.tv_nsec;
+
+            usz Read = 0;
+            while(Read < *Size)
+            {
+                ssize_t Count = pread(Fd, (u8*)Data + Read, *Size - Read, (off_t)(Offset + Read));
+                if(Count <= 0)
+                {
+                    break;
+                }
+
+                Read += Count;
+            }
+
+            *Size = Read;
+            Result = 1;
+        }
+
+        close(Fd);
+    }
+
+    return Result;
 }
 
-#define GL_DEBUG_OUTPUT                   0x92E0
+static void gfxDebugPrint(const char* String)
+{
+    fputs(String, stdout);
+}
 
-typedef void (*GLDEBUGPROC) (GLenum source,GLenum type,GLuint id,GLenum severity,GLsizei length,const GLchar *message,const void *userParam);
+typedef struct
+{
+    int Fd;
+} gfx_watch;
 
-typedef void (*PFNGLDEBUGMESSAGECALLBACKPROC) (GLDEBUGPROC callback, const void *userParam);
+static b32 gfxWatchOpen(gfx_watch* Watch, const char* Name)
+{
+    b32 Result = 0;
 
-static void (*glDebugMessageCallback) (GLDEBUGPROC callback, const void *userParam);
+    Watch->Fd = inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+    if(Watch->Fd != -1)
+    {
+        // NOTE: Moves and deletes are reported too, rotated logs are found again by name
+        if(inotify_add_watch(Watch->Fd, Name, IN_MODIFY|IN_ATTRIB|IN_MOVE_SELF|IN_DELETE_SELF) != -1)
+        {
+            Result = 1;
+        }
+        else
+        {
+            close(Watch->Fd);
+        }
+    }
 
+    return Result;
+}
 
-static gfx_buf gfxLoadBuf(const char* Name)
+// NOTE: Drains the pending events, returns 1 when there were any
+static b32 gfxWatchPoll(gfx_watch* Watch)
 {
-    gfx_buf Result = {0};
+    b32 Result = 0;
 
-    Result.At = gfxLoadFile(Name, &Result.Sz);
+    char Events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    while(read(Watch->Fd, Events, sizeof(Events)) > 0)
+    {
+        Result = 1;
+    }
 
     return Result;
 }
 
-static b32 gfxHexToDec(char C, u8* V)
+static void gfxWatchClose(gfx_watch* Watch)
 {
-    if(C >= 'a' && C <= 'f')
+    close(Watch->Fd);
+}
+
+typedef struct
+{
+    gfx_thread_proc* Proc;
+    void* Param;
+    pthread_t Handle;
+} gfx_thread;
+
+typedef sem_t gfx_sem;
+
+static void* gfxThreadMain(void* Param)
+{
+    gfx_thread* Thread = (gfx_thread*) Param;
+    Thread->Proc(Thread->Param);
+    return 0;
+}
+
+static b32 gfxThreadStart(gfx_thread* Thread)
+{
+    return pthread_create(&Thread->Handle, 0, gfxThreadMain, Thread) == 0;
+}
+
+static void gfxThreadJoin(gfx_thread* Thread)
+{
+    pthread_join(Thread->Handle, 0);
+}
+
+static b32 gfxSemInit(gfx_sem* Sem)
+{
+    return sem_init(Sem, 0, 0) == 0;
+}
+
+static void gfxSemWait(gfx_sem* Sem)
+{
+    while(sem_wait(Sem) != 0)
     {
-        *V = C - 'a' + 10;
+        // NOTE: Interrupted by a signal
     }
-    else if(C >= 'A' && C <= 'F')
+}
+
+static void gfxSemPost(gfx_sem* Sem, u32 Count)
+{
+    while(Count--)
     {
-        *V = C - 'A' + 10;
+        sem_post(Sem);
     }
-    else if(C >= '0' && C <= '9')
+}
+
+static void gfxSemFree(gfx_sem* Sem)
+{
+    sem_destroy(Sem);
+}
+
+static u32 gfxAtomicInc(volatile u32* Value)
+{
+    return __atomic_fetch_add(Value, 1, __ATOMIC_SEQ_CST);
+}
+
+static u32 gfxAtomicLoad(volatile u32* Value)
+{
+    return __atomic_load_n(Value, __ATOMIC_ACQUIRE);
+}
+
+static void gfxAtomicStore(volatile u32* Value, u32 New)
+{
+    __atomic_store_n(Value, New, __ATOMIC_RELEASE);
+}
+
+static u32 gfxBitScan(u64 Value)
+{
+    return (u32) __builtin_ctzll(Value);
+}
+
+static u32 gfxBitCount(u64 Value)
+{
+    return (u32) __builtin_popcountll(Value);
+}
+
+static u64 gfxTsc(void)
+{
+    return __builtin_ia32_rdtsc();
+}
+
+#define GFX_THREAD_LOCAL __thread
+
+static u32 gfxCpuCount(void)
+{
+    long Count = sysconf(_SC_NPROCESSORS_ONLN);
+    return Count > 0 ? (u32) Count : 1;
+}
+
+static u64 gfxClock(void)
+{
+    struct timespec Time;
+    clock_gettime(CLOCK_MONOTONIC, &Time);
+    return (u64)Time.tv_sec * 1000000000ull + Time.tv_nsec;
+}
+
+#endif
+
+static void gfxError(const char* Format, ...)
+{
+    char String[1024];
+
+    va_list VaList;
+    va_start(VaList, Format);
+    vsnprintf(String, sizeof(String), Format, VaList);
+    va_end(VaList);
+
+    gfxDebugPrint(String);
+
+    Assert(0);
+}
+
+static void gfxDebug(const char* Format, ...)
+{
+    char String[1024];
+
+    va_list VaList;
+    va_start(VaList, Format);
+    vsnprintf(String, sizeof(String), Format, VaList);
+    va_end(VaList);
+
+    gfxDebugPrint(String);
+}
+
+static usz gfxFormatV(char* Buffer, usz Length, const char* Format, va_list Args)
+{
+    int Ret = vsnprintf(Buffer, Length, Format, Args);
+    if(Ret < 0)
     {
-        *V = C - '0';
+        Ret = 0;
     }
-    else
+
+    usz Count = (usz) Ret;
+    if(Count >= Length)
     {
-        return 0;
+        Count = (int)Length-1;
     }
 
-    return 1;
+    Buffer[Count] = 0;
+    return (usz)Count;
 }
 
-static b32 gfxStrEqu(gfx_str* Str, const char* Cmp)
+static usz gfxFormat(char* Buffer, usz Length, const char* Format, ...)
 {
-    for(usz Idx = 0; Idx < Str->Sz; Idx++)
+    usz Result;
+
+    va_list Args;
+    va_start(Args, Format);
+    Result = gfxFormatV(Buffer, Length, Format, Args);
+    va_end(Args);
+
+    return Result;
+}
+
+//
+// ARENA
+//
+
+#define GFX_ARENA_RESERVE ((usz)1 << 30) // Address space of every arena, only touched pages are committed
+#define GFX_ARENA_COMMIT 0x10000
+
+typedef struct
+{
+    u8* Base;
+    usz Committed;
+    usz Used;
+} gfx_arena;
+
+static gfx_arena GfxArena; // Never reset
+static gfx_arena GfxFrameArenas[2];
+static gfx_arena* GfxFrameArena = &GfxFrameArenas[0]; // Reset by gfxEndFrame of the next frame, so data of the previous frame is still valid
+
+// NOTE: 16 byte aligned and not zeroed, the range is reserved at the first push
+static void* gfxArenaPush(gfx_arena* Arena, usz Size)
+{
+    if(!Arena->Base)
     {
-        if(Cmp[Idx] != Str->At[Idx])
-        {
-            return 0;
-        }
+        Assert(Arena->Base = gfxVirtualReserve(GFX_ARENA_RESERVE));
     }
 
-    return (Cmp[Str->Sz] == 0);
+    usz Used = (Arena->Used + 15) & ~(usz)15;
+    Assert(Size <= GFX_ARENA_RESERVE - Used);
+
+    if(Used + Size > Arena->Committed)
+    {
+        usz Commit = (Used + Size - Arena->Committed + GFX_ARENA_COMMIT - 1) & ~(usz)(GFX_ARENA_COMMIT - 1);
+        Commit = Min(Commit, GFX_ARENA_RESERVE - Arena->Committed);
+        Assert(gfxVirtualCommit(Arena->Base + Arena->Committed, Commit));
+        Arena->Committed += Commit;
+    }
+
+    Arena->Used = Used + Size;
+    return Arena->Base + Used;
 }
 
-static b32 gfxStrToU32(gfx_str* Str, u32* Val)
+// NOTE: Pages stay committed for the next round
+static void gfxArenaReset(gfx_arena* Arena)
 {
-    if(!Str->Sz)
+    Arena->Used = 0;
+}
+
+static void gfxArenaFree(gfx_arena* Arena)
+{
+    if(Arena->Base)
     {
-        // TODO: Logging
-        return 0;
+        gfxVirtualRelease(Arena->Base, GFX_ARENA_RESERVE);
     }
 
-    u32 Tmp = 0;
+    memset(Arena, 0, sizeof(*Arena));
+}
 
-    do
-    {
-        char C = *Str->At;
+// NOTE: Formats a string of any length into the arena
+static char* gfxArenaFormat(gfx_arena* Arena, usz* Length, const char* Format, ...)
+{
+    va_list Args;
+    va_start(Args, Format);
+
+    va_list Copy;
+    va_copy(Copy, Args);
+    int Ret = vsnprintf(0, 0, Format, Copy);
+    va_end(Copy);
+
+    usz Count = (Ret > 0) ? (usz)Ret : 0;
+    char* Result = gfxArenaPush(Arena, Count + 1);
+    *Length = gfxFormatV(Result, Count + 1, Format, Args);
+
+    va_end(Args);
+    return Result;
+}
+
+//
+// TRACE
+//
+
+#if GFX_TRACE
+
+#define GFX_TRACE_THREADS 16
+#define GFX_TRACE_EVENTS 0x8000 // Per thread, power of two
 
-        if(C < '0' && C > '9')
+typedef enum
+{
+    GFX_TRACE_EVENT_BEGIN,
+    GFX_TRACE_EVENT_END,
+} gfx_trace_kind;
+
+typedef struct
+{
+    u64 Tsc;
+    const char* Name; // Static string, only the pointer is kept
+    u32 Kind;
+    u32 Frame;
+} gfx_trace_event;
+
+typedef struct
+{
+    u64 Count; // Events ever written, the ring keeps the last GFX_TRACE_EVENTS
+    gfx_trace_event Events[GFX_TRACE_EVENTS];
+} gfx_trace_ring;
+
+static gfx_trace_ring GfxTraceRings[GFX_TRACE_THREADS];
+static volatile u32 GfxTraceRingCount;
+static volatile u32 GfxTraceFrame;
+static u64 GfxTraceTsc0;
+static u64 GfxTraceClock0;
+static GFX_THREAD_LOCAL gfx_trace_ring* GfxTraceRing;
+
+static void gfxTraceEvent(const char* Name, u32 Kind)
+{
+    gfx_trace_ring* Ring = GfxTraceRing;
+    if(!Ring)
+    {
+        u32 Index = gfxAtomicInc(&GfxTraceRingCount);
+        if(Index >= GFX_TRACE_THREADS)
         {
-            // TODO: Logging
-            return 0;
+            return;
         }
 
-        u32 N = Tmp * 10 + (C - '0');
-        if(N < Tmp)
+        if(Index == 0)
         {
-            // TODO: Logging
-            return 0;
+            GfxTraceTsc0 = gfxTsc();
+            GfxTraceClock0 = gfxClock();
         }
 
-        Tmp = N;
-        Str->Sz--;
-        Str->At++;
+        Ring = GfxTraceRing = &GfxTraceRings[Index];
     }
-    while(Str->Sz);
 
-    *Val = Tmp;
-
-    return 1;
+    gfx_trace_event* Event = &Ring->Events[Ring->Count & (GFX_TRACE_EVENTS - 1)];
+    Event->Tsc = gfxTsc();
+    Event->Name = Name;
+    Event->Kind = Kind;
+    Event->Frame = GfxTraceFrame;
+    Ring->Count++;
 }
 
-static b32 gfxGetLine(gfx_str* Str, gfx_str* Line)
+// NOTE: Writes events of the last Frames frames as Chrome trace-event JSON, call while no other thread traces
+static b32 gfxTraceDump(const char* Path, u32 Frames)
 {
     b32 Result = 0;
 
-    if(Str->Sz)
+    FILE* File = fopen(Path, "wb");
+    if(File)
     {
-        Line->At = Str->At;
+        // NOTE: TSC rate from the two ends of the run, no calibration sleep needed
+        u64 Tsc1 = gfxTsc();
+        u64 Clock1 = gfxClock();
+        f64 UsPerTick = 0.0;
+        if(Tsc1 > GfxTraceTsc0)
+        {
+            UsPerTick = (Clock1 - GfxTraceClock0) / (1000.0 * (Tsc1 - GfxTraceTsc0));
+        }
 
-        while(Str->Sz)
+        u32 FirstFrame = (GfxTraceFrame + 1 > Frames) ? GfxTraceFrame + 1 - Frames : 0;
+        u32 RingCount = Min(GfxTraceRingCount, GFX_TRACE_THREADS);
+
+        fputs("{\"traceEvents\":[\n", File);
+        b32 First = 1;
+        for(u32 Thread = 0; Thread < RingCount; Thread++)
         {
-            char C = *(Str->At++);
-            Str->Sz--;
-            if(C == '\n')
+            gfx_trace_ring* Ring = &GfxTraceRings[Thread];
+            u64 Start = (Ring->Count > GFX_TRACE_EVENTS) ? Ring->Count - GFX_TRACE_EVENTS : 0;
+            for(u64 Idx = Start; Idx < Ring->Count; Idx++)
             {
-                break;
+                gfx_trace_event* Event = &Ring->Events[Idx & (GFX_TRACE_EVENTS - 1)];
+                if(Event->Frame >= FirstFrame)
+                {
+                    f64 Us = (i64)(Event->Tsc - GfxTraceTsc0) * UsPerTick;
+                    fprintf(File, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"frame\":%u}}",
+                            First ? "" : ",\n", Event->Name, Event->Kind == GFX_TRACE_EVENT_BEGIN ? 'B' : 'E', Us, Thread, Event->Frame);
+                    First = 0;
+                }
             }
         }
+        fputs("\n]}\n", File);
 
-        Line->Sz = Str->At - Line->At - 1;
-
-        Result = 1;
+        Result = !ferror(File);
+        fclose(File);
     }
 
     return Result;
 }
 
-static b32 gfxTokenize(gfx_str* Str, gfx_str* Token)
+#define GFX_TRACE_BEGIN(Name) gfxTraceEvent(Name, GFX_TRACE_EVENT_BEGIN)
+#define GFX_TRACE_END(Name) gfxTraceEvent(Name, GFX_TRACE_EVENT_END)
+#define GFX_TRACE_FRAME(Frame) (GfxTraceFrame = (u32)(Frame))
+
+#else
+
+static b32 gfxTraceDump(const char* Path, u32 Frames)
+{
+    gfxDebug("Tracing is compiled out, build with -DBUILD_TRACE\n");
+    return 0;
+}
+
+#define GFX_TRACE_BEGIN(Name)
+#define GFX_TRACE_END(Name)
+#define GFX_TRACE_FRAME(Frame)
+
+#endif
+
+#if GFX_GL
+
+static void APIENTRY gfxGlCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const char* message, const void* userParam)
+{
+    gfxError( "GL CALLBACK: %s type = 0x%x, severity = 0x%x, message = %s\n",
+           ( type == GL_DEBUG_TYPE_ERROR ? "** GL ERROR **" : "" ),
+            type, severity, message );
+}
+
+static PFNGLDEBUGMESSAGECALLBACKPROC glDebugMessageCallback;
+
+#define GFX_GL_CORE_PROCS \
+    X(PFNGLGENVERTEXARRAYSPROC, glGenVertexArrays) \
+    X(PFNGLBINDVERTEXARRAYPROC, glBindVertexArray) \
+    X(PFNGLGENBUFFERSPROC, glGenBuffers) \
+    X(PFNGLBINDBUFFERPROC, glBindBuffer) \
+    X(PFNGLBUFFERDATAPROC, glBufferData) \
+    X(PFNGLBUFFERSUBDATAPROC, glBufferSubData) \
+    X(PFNGLENABLEVERTEXATTRIBARRAYPROC, glEnableVertexAttribArray) \
+    X(PFNGLVERTEXATTRIBPOINTERPROC, glVertexAttribPointer) \
+    X(PFNGLCREATESHADERPROC, glCreateShader) \
+    X(PFNGLSHADERSOURCEPROC, glShaderSource) \
+    X(PFNGLCOMPILESHADERPROC, glCompileShader) \
+    X(PFNGLGETSHADERIVPROC, glGetShaderiv) \
+    X(PFNGLGETSHADERINFOLOGPROC, glGetShaderInfoLog) \
+    X(PFNGLDELETESHADERPROC, glDeleteShader) \
+    X(PFNGLCREATEPROGRAMPROC, glCreateProgram) \
+    X(PFNGLATTACHSHADERPROC, glAttachShader) \
+    X(PFNGLLINKPROGRAMPROC, glLinkProgram) \
+    X(PFNGLGETPROGRAMIVPROC, glGetProgramiv) \
+    X(PFNGLGETPROGRAMINFOLOGPROC, glGetProgramInfoLog) \
+    X(PFNGLUSEPROGRAMPROC, glUseProgram) \
+    X(PFNGLGETUNIFORMLOCATIONPROC, glGetUniformLocation) \
+    X(PFNGLUNIFORM1IPROC, glUniform1i) \
+    X(PFNGLUNIFORM2FPROC, glUniform2f) \
+    X(PFNGLUNIFORM3IPROC, glUniform3i) \
+    X(PFNGLUNIFORM4FPROC, glUniform4f) \
+    X(PFNGLUNIFORMMATRIX4FVPROC, glUniformMatrix4fv)
+
+// NOTE: OpenGL 1.2 and 1.3 functions are exported by libGL, but not by opengl32.dll
+#if defined(BUILD_WIN32)
+#define GFX_GL_LEGACY_PROCS \
+    X(PFNGLACTIVETEXTUREPROC, glActiveTexture)
+#else
+#define GFX_GL_LEGACY_PROCS
+#endif
+
+#define X(Type, Name) static Type Name;
+GFX_GL_CORE_PROCS
+GFX_GL_LEGACY_PROCS
+#undef X
+
+#endif
+
+typedef enum
+{
+    GFX_BACKEND_COMPAT, // Fixed-function pipeline, client-side arrays
+    GFX_BACKEND_CORE,   // OpenGL 3.3 core profile, shaders and buffers
+    GFX_BACKEND_SOFT,   // CPU rasterizer into a memory framebuffer
+} gfx_backend;
+
+static gfx_backend GfxBackend;
+
+
+static gfx_buf gfxLoadBuf(const char* Name)
+{
+    gfx_buf Result = {0};
+
+    Result.At = gfxLoadFile(Name, &Result.Sz);
+
+    return Result;
+}
+
+static b32 gfxHexToDec(char C, u8* V)
+{
+    if(C >= 'a' && C <= 'f')
+    {
+        *V = C - 'a' + 10;
+    }
+    else if(C >= 'A' && C <= 'F')
+    {
+        *V = C - 'A' + 10;
+    }
+    else if(C >= '0' && C <= '9')
+    {
+        *V = C - '0';
+    }
+    else
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+static b32 gfxStrEqu(gfx_str* Str, const char* Cmp)
+{
+    for(usz Idx = 0; Idx < Str->Sz; Idx++)
+    {
+        if(Cmp[Idx] != Str->At[Idx])
+        {
+            return 0;
+        }
+    }
+
+    return (Cmp[Str->Sz] == 0);
+}
+
+static b32 gfxStrToU32(gfx_str* Str, u32* Val)
+{
+    if(!Str->Sz)
+    {
+        // TODO: Logging
+        return 0;
+    }
+
+    u32 Tmp = 0;
+
+    do
+    {
+        char C = *Str->At;
+
+        if(C < '0' || C > '9')
+        {
+            // TODO: Logging
+            return 0;
+        }
+
+        u32 N = Tmp * 10 + (C - '0');
+        if(N < Tmp)
+        {
+            // TODO: Logging
+            return 0;
+        }
+
+        Tmp = N;
+        Str->Sz--;
+        Str->At++;
+    }
+    while(Str->Sz);
+
+    *Val = Tmp;
+
+    return 1;
+}
+
+static b32 gfxGetLine(gfx_str* Str, gfx_str* Line)
+{
+    b32 Result = 0;
+
+    if(Str->Sz)
+    {
+        Line->At = Str->At;
+
+        while(Str->Sz)
+        {
+            char C = *(Str->At++);
+            Str->Sz--;
+            if(C == '\n')
+            {
+                break;
+            }
+        }
+
+        Line->Sz = Str->At - Line->At - 1;
+
+        Result = 1;
+    }
+
+    return Result;
+}
+
+static b32 gfxTokenize(gfx_str* Str, gfx_str* Token)
+{
+    b32 Result = 0;
+
+    if(Str->Sz)
+    {
+        while(Str->Sz && *Str->At == ' ')
+        {
+            Str->Sz--;
+            Str->At++;
+        }
+
+        Token->At = Str->At;
+
+        while(Str->Sz && *Str->At != ' ')
+        {
+            Str->At++;
+            Str->Sz--;
+        }
+
+        Token->Sz = Str->At - Token->At;
+
+        Result = 1;
+    }
+
+    return Result;
+}
+
+static b32 gfxParseLine(gfx_str* Str, gfx_str* Tokens, usz Count)
+{
+    b32 Result = 0;
+
+    gfx_str Line;
+    if(gfxGetLine(Str, &Line))
+    {
+        usz Idx = 0;
+        while(Idx < Count && gfxTokenize(&Line, &Tokens[Idx]))
+        {
+            Idx++;
+        }
+
+        Result = 1;
+    }
+
+    return Result;
+}
+
+static b32 gfxReadFnt(gfx_fnt* Fnt, gfx_str* Str)
+{
+    gfx_str Tokens[8] = {0};
+    if(gfxParseLine(Str, Tokens, ArrLen(Tokens)) &&
+       gfxStrEqu(&Tokens[0], "STARTFONT"))
+    {
+        u32 Capacity = 0;
+        while(1) // TODO: Break it
+        {
+            if(!gfxParseLine(Str, Tokens, ArrLen(Tokens)))
+            {
+                // TODO: Logging
+                return 0;
+            }
+
+            if(gfxStrEqu(Tokens+0, "FONTBOUNDINGBOX"))
+            {
+                if(!gfxStrToU32(Tokens+1, &Fnt->Width) ||
+                   !gfxStrToU32(Tokens+2, &Fnt->Height))
+                {
+                    // TODO: Logging
+                    return 0;
+                }
+
+                Fnt->Cols = Fnt->Width;
+                Fnt->Rows = Fnt->Height;
+            }
+            else if(gfxStrEqu(Tokens+0, "DEFAULT_CHAR"))
+            {
+                if(!gfxStrToU32(Tokens+1, &Fnt->Default))
+                {
+                    // TODO: Logging
+                    return 0;
+                }
+            }
+            else if(gfxStrEqu(Tokens+0, "CHARS"))
+            {
+                if(Fnt->Codes)
+                {
+                    gfxVirtualFree(Fnt->Codes);
+                }
+
+                if(!gfxStrToU32(Tokens+1, &Capacity))
+                {
+                    // TODO: Logging
+                    return 0;
+                }
+
+                Capacity = Min(Capacity, GFX_FNT_SLOTS);
+
+                Fnt->Skip = (Fnt->Width + 7) / 8;
+                Fnt->Jump = Fnt->Skip * Fnt->Height;
+                Fnt->Count = 0;
+
+                // NOTE: Codes and bitmaps share one block, like in the cache file
+                usz Size = Capacity * (sizeof(u32) + Fnt->Jump);
+                Fnt->Codes = gfxVirtualAlloc(Size);
+                if(!Fnt->Codes)
+                {
+                    // TODO: Logging
+                    return 0;
+                }
+
+                Fnt->Capacity = Capacity;
+
+                memset(Fnt->Codes, 0, Size);
+                Fnt->Data = (u8*) (Fnt->Codes + Capacity);
+            }
+            else if(gfxStrEqu(Tokens+0, "STARTCHAR"))
+            {
+                b32 Encoded = 0;
+                while(1) // TODO: Break it
+                {
+                    if(!gfxParseLine(Str, Tokens, ArrLen(Tokens)))
+                    {
+                        // TODO: Logging
+                        return 0;
+                    }
+
+                    if(gfxStrEqu(Tokens+0, "ENCODING"))
+                    {
+                        u32 Encoding = 0;
+                        if(!gfxStrToU32(Tokens+1, &Encoding) ||
+                           Encoding >= GFX_FNT_CODES ||
+                           Fnt->Count >= Capacity)
+                        {
+                            // NOTE: Unencoded glyph (ENCODING -1) or too many glyphs
+                            break;
+                        }
+
+                        Fnt->Codes[Fnt->Count] = Encoding;
+                        Encoded = 1;
+                    }
+                    else if(gfxStrEqu(Tokens+0, "BITMAP"))
+                    {
+                        if(!Encoded)
+                        {
+                            // NOTE: No ENCODING line before, so no slot was checked against the capacity
+                            break;
+                        }
+
+                        u8* RowAt = Fnt->Data + Fnt->Count * Fnt->Jump;
+                        for(u32 Row = 0; Row < Fnt->Height; Row++)
+                        {
+                            gfx_str Line;
+                            if(!gfxGetLine(Str, &Line))
+                            {
+                                // TODO: Logging
+                                return 0;
+                            }
+
+                            if(Line.Sz < 2*Fnt->Skip)
+                            {
+                                // TODO: Logging
+                                return 0;
+                            }
+
+                            for(u32 Idx = 0; Idx < Fnt->Skip; Idx++)
+                            {
+                                u8 Hi = 0, Lo = 0;
+                                if(!gfxHexToDec(Line.At[2*Idx+0], &Hi) ||
+                                   !gfxHexToDec(Line.At[2*Idx+1], &Lo))
+                                {
+                                    // TODO: Logging
+                                    return 0;
+                                }
+
+                                *(RowAt++) = (Hi << 4) | Lo;
+                            }
+                        }
+                    }
+                    else if(gfxStrEqu(Tokens+0, "ENDCHAR"))
+                    {
+                        Fnt->Count += Encoded;
+                        break;
+                    }
+                }
+            }
+            else if(gfxStrEqu(Tokens+0, "ENDFONT"))
+            {
+                break;
+            }
+        }
+
+        Fnt->Size = Fnt->Count * Fnt->Jump;
+    }
+
+    return (Fnt->Count != 0);
+}
+
+static b32 gfxIndexFnt(gfx_fnt* Fnt)
+{
+    b32 Result = 0;
+
+    u32 Default = 0;
+    u32 Count = 1;
+    static u8 Used[GFX_FNT_BLOCKS];
+    memset(Used, 0, sizeof(Used));
+    for(u32 Slot = 0; Slot < Fnt->Count; Slot++)
+    {
+        u32 Code = Fnt->Codes[Slot];
+        if(Code >= GFX_FNT_CODES)
+        {
+            // TODO: Logging
+            return 0;
+        }
+
+        if(!Used[Code >> 8])
+        {
+            Used[Code >> 8] = 1;
+            Count++;
+        }
+
+        if(Code == Fnt->Default)
+        {
+            Default = Slot;
+        }
+    }
+
+    usz Size = (GFX_FNT_BLOCKS + Count * 256) * sizeof(u16);
+    u16* Index = gfxVirtualAlloc(Size);
+    if(Index)
+    {
+        Fnt->Dir = Index;
+        Fnt->Pages = Index + GFX_FNT_BLOCKS;
+        Fnt->PageCount = Count;
+
+        memset(Fnt->Dir, 0, GFX_FNT_BLOCKS * sizeof(u16));
+        for(u32 Idx = 0; Idx < Count * 256; Idx++)
+        {
+            Fnt->Pages[Idx] = (u16) Default;
+        }
+
+        u16 Page = 1;
+        for(u32 Slot = 0; Slot < Fnt->Count; Slot++)
+        {
+            u32 Code = Fnt->Codes[Slot];
+            if(!Fnt->Dir[Code >> 8])
+            {
+                Fnt->Dir[Code >> 8] = Page++;
+            }
+
+            Fnt->Pages[Fnt->Dir[Code >> 8] * 256 + (Code & 0xFF)] = (u16) Slot;
+        }
+
+        Result = 1;
+    }
+    else
+    {
+        // TODO: Logging
+    }
+
+    return Result;
+}
+
+static u32 gfxGlyph(gfx_fnt* Fnt, u32 Code)
+{
+    u32 Page = (Code < GFX_FNT_CODES) ? Fnt->Dir[Code >> 8] : 0;
+    return Fnt->Pages[Page * 256 + (Code & 0xFF)];
+}
+
+static void gfxExpandFnt(gfx_fnt* Fnt, u8* Pixels)
+{
+    u32 Pitch = Fnt->Width * Fnt->TexCols;
+
+    u8* WhiteRow = Pixels + (Fnt->Count / Fnt->TexCols) * Fnt->Height * Pitch + (Fnt->Count % Fnt->TexCols) * Fnt->Width;
+    for(u32 Row = 0; Row < Fnt->Height; Row++)
+    {
+        memset(WhiteRow, 0xFF, Fnt->Width);
+        WhiteRow += Pitch;
+    }
+
+    for(u32 Slot = 0; Slot < Fnt->Count; Slot++)
+    {
+        u8* RowAt = Fnt->Data + Slot * Fnt->Jump;
+        u8* PixelRow = Pixels + (Slot / Fnt->TexCols) * Fnt->Height * Pitch + (Slot % Fnt->TexCols) * Fnt->Width;
+        for(u32 Row = 0; Row < Fnt->Height; Row++)
+        {
+            for(u32 Col = 0; Col < Fnt->Width; Col++)
+            {
+                u8 Bits = RowAt[Col / 8];
+                PixelRow[Col] = (Bits & (0x80 >> (Col % 8))) ? 0xFF : 0x00;
+            }
+
+            RowAt += Fnt->Skip;
+            PixelRow += Pitch;
+        }
+    }
+}
+
+static void gfxLayoutFnt(gfx_fnt* Fnt)
+{
+    // NOTE: Near-square grid, so TexCols * Cols is about TexRows * Rows
+    u32 Cells = Fnt->Count + 1;
+    u32 TexCols = (u32) ceilf(sqrtf((f32)Cells * Fnt->Height / Fnt->Width));
+    Fnt->TexCols = Clamp(1, Cells, TexCols);
+    Fnt->TexRows = (Cells + Fnt->TexCols - 1) / Fnt->TexCols;
+    Fnt->TexSize = Fnt->Width * Fnt->TexCols * Fnt->Height * Fnt->TexRows;
+
+    f32 DU = 1.0f / Fnt->TexCols;
+    f32 DV = 1.0f / Fnt->TexRows;
+    for(u32 Slot = 0; Slot < Fnt->Count; Slot++)
+    {
+        f32* Uv = Fnt->Uvs + 4 * Slot;
+        Uv[0] = (Slot % Fnt->TexCols) * DU;
+        Uv[1] = (Slot / Fnt->TexCols) * DV;
+        Uv[2] = Uv[0] + DU;
+        Uv[3] = Uv[1] + DV;
+    }
+
+    Fnt->White[0] = ((Fnt->Count % Fnt->TexCols) + 0.5f) * DU;
+    Fnt->White[1] = ((Fnt->Count / Fnt->TexCols) + 0.5f) * DV;
+}
+
+static b32 gfxUploadFnt(gfx_fnt* Fnt)
+{
+    b32 Result = 0;
+
+    if(!Fnt->Uvs)
+    {
+        Fnt->Uvs = gfxVirtualAlloc(Fnt->Count * 4 * sizeof(f32));
+        if(!Fnt->Uvs)
+        {
+            // TODO: Logging
+            return 0;
+        }
+    }
+
+    gfxLayoutFnt(Fnt);
+
+    if(GfxBackend == GFX_BACKEND_SOFT)
+    {
+        // NOTE: Software rasterizer blits straight from the 1-bit bitmaps
+        Fnt->TexSize = 0;
+        return 1;
+    }
+
+#if GFX_GL
+    GLint MaxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &MaxSize);
+    if(Fnt->Width * Fnt->TexCols > (u32)MaxSize ||
+       Fnt->Height * Fnt->TexRows > (u32)MaxSize)
+    {
+        gfxDebug("Font atlas %ux%u exceeds GL_MAX_TEXTURE_SIZE %d\n",
+                 Fnt->Width * Fnt->TexCols, Fnt->Height * Fnt->TexRows, MaxSize);
+        return 0;
+    }
+
+    u8* Pixels = gfxVirtualAlloc(Fnt->TexSize);
+    if(Pixels)
+    {
+        memset(Pixels, 0, Fnt->TexSize);
+        gfxExpandFnt(Fnt, Pixels);
+
+        GLuint Texture;
+        glGenTextures(1, &Texture);
+        glBindTexture(GL_TEXTURE_2D, Texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        if(GfxBackend == GFX_BACKEND_CORE)
+        {
+            // NOTE: Swizzle coverage into all channels, like GL_INTENSITY
+            GLint Swizzle[] = {GL_RED, GL_RED, GL_RED, GL_RED};
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, Fnt->Width * Fnt->TexCols, Fnt->Height * Fnt->TexRows, 0, GL_RED, GL_UNSIGNED_BYTE, Pixels);
+            glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, Swizzle);
+        }
+        else
+        {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_INTENSITY8, Fnt->Width * Fnt->TexCols, Fnt->Height * Fnt->TexRows, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, Pixels);
+            glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        Fnt->Texture = Texture;
+        Result = 1;
+
+        gfxVirtualFree(Pixels);
+    }
+    else
+    {
+        // TODO: Logging
+    }
+#endif
+
+    return Result;
+}
+
+static void gfxFreeFnt(gfx_fnt* Fnt)
+{
+    if(Fnt->Map)
+    {
+        gfxUnmapFile(Fnt->Map, Fnt->MapSize);
+        Fnt->Map = 0;
+        Fnt->MapSize = 0;
+    }
+    else if(Fnt->Codes)
+    {
+        gfxVirtualFree(Fnt->Codes);
+    }
+
+    if(Fnt->Dir)
+    {
+        gfxVirtualFree(Fnt->Dir);
+    }
+
+    if(Fnt->Uvs)
+    {
+        gfxVirtualFree(Fnt->Uvs);
+    }
+
+    Fnt->Codes = 0;
+    Fnt->Data = 0;
+    Fnt->Dir = 0;
+    Fnt->Pages = 0;
+    Fnt->Uvs = 0;
+    Fnt->Count = 0;
+    Fnt->Capacity = 0;
+    Fnt->PageCount = 0;
+}
+
+static b32 gfxParseBdf(gfx_fnt* Fnt, const char* Name)
+{
+    GFX_TRACE_BEGIN("gfxParseBdf");
+
+    b32 Result = 0;
+
+    usz Size = 0;
+    i8* Data = gfxLoadFile(Name, &Size);
+    if(Data)
+    {
+        Data[Size] = 0;
+
+        gfx_str Buf = {0};
+        Buf.Sz = Size;
+        Buf.At = Data;
+        if(gfxReadFnt(Fnt, &Buf) && gfxIndexFnt(Fnt))
+        {
+            Result = 1;
+        }
+        else
+        {
+            gfxFreeFnt(Fnt);
+        }
+
+        gfxVirtualFree(Data);
+    }
+
+    GFX_TRACE_END("gfxParseBdf");
+    return Result;
+}
+
+static b32 gfxLoadBdf(gfx_fnt* Fnt, const char* Name)
+{
+    GFX_TRACE_BEGIN("gfxLoadBdf");
+
+    b32 Result = 0;
+
+    if(gfxParseBdf(Fnt, Name))
+    {
+        if(gfxUploadFnt(Fnt))
+        {
+            Result = 1;
+        }
+        else
+        {
+            gfxFreeFnt(Fnt);
+        }
+    }
+
+    GFX_TRACE_END("gfxLoadBdf");
+    return Result;
+}
+
+//
+// Font cache: header, u32 Codes[Count] with the encoding of every glyph
+// slot, then Count 1-bit bitmaps laid out exactly like gfx_fnt.Data, so
+// that a mapped cache can be used without any copy.
+//
+
+#define GFX_FNC_MAGIC   0x31434E46 // "FNC1"
+#define GFX_FNC_VERSION 2
+
+typedef struct
+{
+    u32 Magic;
+    u32 Version;
+    u64 SrcSize;
+    u64 SrcTime;
+    u32 Cols;
+    u32 Rows;
+    u32 Count;
+    u32 Default;
+    // u32 Codes[Count];
+    // u8 Bitmaps[Count * Rows * ((Cols + 7) / 8)];
+} gfx_fnc;
+
+static b32 gfxMapFnc(gfx_fnt* Fnt, const char* Name, u64 SrcSize, u64 SrcTime)
+{
+    b32 Result = 0;
+
+    usz Size = 0;
+    u8* Data = gfxMapFile(Name, &Size);
+    if(Data)
+    {
+        gfx_fnc* Fnc = (gfx_fnc*) Data;
+        if(Size >= sizeof(*Fnc) &&
+           Fnc->Magic == GFX_FNC_MAGIC &&
+           Fnc->Version == GFX_FNC_VERSION &&
+           Fnc->SrcSize == SrcSize &&
+           Fnc->SrcTime == SrcTime &&
+           Fnc->Count && Fnc->Count <= GFX_FNT_SLOTS)
+        {
+            u32 Skip = (Fnc->Cols + 7) / 8;
+            u64 Jump = (u64)Skip * Fnc->Rows;
+            u64 Offset = sizeof(*Fnc) + (u64)Fnc->Count * sizeof(u32);
+            if(Jump && Size >= Offset + Jump * Fnc->Count)
+            {
+                Fnt->Width = Fnc->Cols;
+                Fnt->Height = Fnc->Rows;
+                Fnt->Cols = Fnc->Cols;
+                Fnt->Rows = Fnc->Rows;
+                Fnt->Skip = Skip;
+                Fnt->Jump = (u32) Jump;
+                Fnt->Size = (u32) (Jump * Fnc->Count);
+                Fnt->Data = Data + Offset;
+                Fnt->Count = Fnc->Count;
+                Fnt->Codes = (u32*) (Fnc + 1);
+                Fnt->Default = Fnc->Default;
+                Fnt->Map = Data;
+                Fnt->MapSize = Size;
+                if(gfxIndexFnt(Fnt))
+                {
+                    Result = 1;
+                }
+                else
+                {
+                    Fnt->Codes = 0;
+                    Fnt->Data = 0;
+                    Fnt->Map = 0;
+                }
+            }
+        }
+
+        if(!Result)
+        {
+            gfxUnmapFile(Data, Size);
+        }
+    }
+
+    return Result;
+}
+
+static b32 gfxSaveFnc(gfx_fnt* Fnt, const char* Name, u64 SrcSize, u64 SrcTime)
+{
+    b32 Result = 0;
+
+    u32 Count = Fnt->Count;
+    usz Size = sizeof(gfx_fnc) + Count * sizeof(u32) + Fnt->Size;
+    u8* Data = gfxVirtualAlloc(Size);
+    if(Data)
+    {
+        gfx_fnc* Fnc = (gfx_fnc*) Data;
+        memset(Fnc, 0, sizeof(*Fnc));
+        Fnc->Magic = GFX_FNC_MAGIC;
+        Fnc->Version = GFX_FNC_VERSION;
+        Fnc->SrcSize = SrcSize;
+        Fnc->SrcTime = SrcTime;
+        Fnc->Cols = Fnt->Width;
+        Fnc->Rows = Fnt->Height;
+        Fnc->Count = Count;
+        Fnc->Default = Fnt->Default;
+
+        u32* Codes = (u32*) (Fnc + 1);
+        memcpy(Codes, Fnt->Codes, Count * sizeof(u32));
+        memcpy(Codes + Count, Fnt->Data, Fnt->Size);
+
+        Result = gfxSaveFile(Name, Data, Size);
+
+        gfxVirtualFree(Data);
+    }
+
+    return Result;
+}
+
+static b32 gfxLoadFnt(gfx_fnt* Fnt, const char* Name)
+{
+    GFX_TRACE_BEGIN("gfxLoadFnt");
+
+    b32 Result = 0;
+
+    char Cache[512];
+    gfxFormat(Cache, sizeof(Cache), "%s.cache", Name);
+
+    u64 SrcSize = 0;
+    u64 SrcTime = 0;
+    b32 HasSrc = gfxFileStamp(Name, &SrcSize, &SrcTime);
+
+    if(gfxMapFnc(Fnt, Cache, SrcSize, SrcTime))
+    {
+        Result = 1;
+    }
+    else if(HasSrc && gfxParseBdf(Fnt, Name))
+    {
+        if(!gfxSaveFnc(Fnt, Cache, SrcSize, SrcTime))
+        {
+            gfxDebug("Failed to write font cache %s\n", Cache);
+        }
+
+        Result = 1;
+    }
+
+    if(Result && !gfxUploadFnt(Fnt))
+    {
+        gfxFreeFnt(Fnt);
+        Result = 0;
+    }
+
+    GFX_TRACE_END("gfxLoadFnt");
+    return Result;
+}
+
+// NOTE: Everything the font holds, the glyph block or the mapped cache, the codepoint index, the atlas
+// rects and the texture
+static usz gfxFntBytes(gfx_fnt* Fnt)
+{
+    usz Result = Fnt->Map ? Fnt->MapSize : (usz)Fnt->Capacity * (sizeof(u32) + Fnt->Jump);
+    if(Fnt->Dir)
+    {
+        Result += (GFX_FNT_BLOCKS + (usz)Fnt->PageCount * 256) * sizeof(u16);
+    }
+
+    if(Fnt->Uvs)
+    {
+        Result += (usz)Fnt->Count * 4 * sizeof(f32);
+    }
+
+    return Result + Fnt->TexSize;
+}
+
+typedef struct
+{
+    u32 Cols; // Drawn image size
+    u32 Rows;
+    u32 Width; // Bitmap size
+    u32 Height;
+    u64 Jump;
+    u64 Size;
+    u8* Data;
+    u32 Texture;
+} gfx_img;
+
+#pragma pack(push, 1)
+typedef struct
+{
+    char Magic[2];
+    u32 FileSize;
+    u32 Reserved;
+    u32 DataOffset;
+} gfx_bmp_file_header;
+
+typedef struct
+{
+    u32 HeaderSize;
+    u32 BitmapWidth;
+    u32 BitmapHeight;
+    u16 ColorPlanes;
+    u16 BitsPerPixel;
+    u32 Compression;
+    u32 ImageSize;
+    u32 HorizontalRes;
+    u32 VerticalRes;
+    u32 PaletteColors;
+    u32 ColorsImportant;
+} gfx_bmp_info_header;
+
+typedef struct
+{
+    gfx_bmp_file_header FileHeader;
+    gfx_bmp_info_header InfoHeader;
+    // u8 Pixels[];
+} gfx_bmp;
+#pragma pack(pop)
+
+static b32 gfxLoadBmp(gfx_img* Img, const char* Path)
+{
+    GFX_TRACE_BEGIN("gfxLoadBmp");
+
+    b32 Result = 0;
+
+    gfx_buf Buf = gfxLoadBuf(Path);
+    if(Buf.At)
+    {
+        gfx_bmp* Bmp;
+        if(Buf.Sz > sizeof(*Bmp))
+        {
+            Bmp = (gfx_bmp*) Buf.At;
+            if(Bmp->FileHeader.Magic[0] == 'B' &&
+               Bmp->FileHeader.Magic[1] == 'M' &&
+               Bmp->InfoHeader.HeaderSize == sizeof(Bmp->InfoHeader))
+            {
+                Img->Width = Bmp->InfoHeader.BitmapWidth;
+                Img->Height = Bmp->InfoHeader.BitmapHeight;
+                Img->Cols = Img->Width;
+                Img->Rows = Img->Height;
+                Img->Jump = (((Img->Width * 3) + 3) / 4) * 4;
+                Img->Size = Img->Jump * Img->Height;
+                if(Buf.Sz >= Bmp->FileHeader.DataOffset + Img->Size)
+                {
+                    Img->Data = Buf.At + Bmp->FileHeader.DataOffset;
+                    Result = 1;
+#if GFX_GL
+                    if(GfxBackend != GFX_BACKEND_SOFT)
+                    {
+                        glGenTextures(1, &Img->Texture);
+                        glBindTexture(GL_TEXTURE_2D, Img->Texture);
+                        glPixelStorei(GL_PACK_ROW_LENGTH, Img->Width);
+                        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, Img->Width, Img->Height, 0, GL_BGR, GL_UNSIGNED_BYTE, Img->Data);
+                        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                        if(GfxBackend == GFX_BACKEND_COMPAT)
+                        {
+                            glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+                        }
+                        glBindTexture(GL_TEXTURE_2D, 0);
+                    }
+#endif
+                }
+                else
+                {
+                    // TODO: Logging
+                }
+            }
+            else
+            {
+                // TODO: Logging
+            }
+        }
+        else
+        {
+            // TODO: Logging
+        }
+    }
+    else
+    {
+        // TODO: Logging
+    }
+
+    GFX_TRACE_END("gfxLoadBmp");
+    return Result;
+}
+
+static b32 gfxSaveBmp(const char* Path, const u32* Pixels, u32 Cols, u32 Rows)
+{
+    b32 Result = 0;
+
+    u32 Jump = (((Cols * 3) + 3) / 4) * 4;
+    usz Size = sizeof(gfx_bmp) + (usz)Jump * Rows;
+    u8* Data = gfxVirtualAlloc(Size);
+    if(Data)
+    {
+        gfx_bmp* Bmp = (gfx_bmp*) Data;
+        memset(Bmp, 0, sizeof(*Bmp));
+        Bmp->FileHeader.Magic[0] = 'B';
+        Bmp->FileHeader.Magic[1] = 'M';
+        Bmp->FileHeader.FileSize = (u32) Size;
+        Bmp->FileHeader.DataOffset = sizeof(gfx_bmp);
+        Bmp->InfoHeader.HeaderSize = sizeof(Bmp->InfoHeader);
+        Bmp->InfoHeader.BitmapWidth = Cols;
+        Bmp->InfoHeader.BitmapHeight = Rows;
+        Bmp->InfoHeader.ColorPlanes = 1;
+        Bmp->InfoHeader.BitsPerPixel = 24;
+        Bmp->InfoHeader.ImageSize = Jump * Rows;
+
+        // NOTE: Bottom-up rows of B, G, R
+        for(u32 Row = 0; Row < Rows; Row++)
+        {
+            const u32* PixelAt = Pixels + (usz)(Rows - 1 - Row) * Cols;
+            u8* At = Data + sizeof(gfx_bmp) + (usz)Row * Jump;
+            for(u32 Col = 0; Col < Cols; Col++)
+            {
+                u32 Pixel = *(PixelAt++);
+                *(At++) = (u8)(Pixel >> 16);
+                *(At++) = (u8)(Pixel >> 8);
+                *(At++) = (u8)(Pixel >> 0);
+            }
+
+            for(u32 Pad = Cols * 3; Pad < Jump; Pad++)
+            {
+                *(At++) = 0;
+            }
+        }
+
+        Result = gfxSaveFile(Path, Data, Size);
+
+        gfxVirtualFree(Data);
+    }
+
+    return Result;
+}
+
+#if GFX_SIMD
+#include <immintrin.h>
+#endif
+
+typedef float m4f[16];
+typedef float v4f[4];
+typedef float v2f[2];
+typedef float v3f[3];
+
+// NOTE: Matrices are column-major like OpenGL, M[4*Col+Row], and may be unaligned
+
+#if GFX_SIMD
+#define GFX_SHUFFLE(A, B, X, Y, Z, W) _mm_shuffle_ps(A, B, _MM_SHUFFLE(W, Z, Y, X))
+#define GFX_SWIZZLE(A, X, Y, Z, W) GFX_SHUFFLE(A, A, X, Y, Z, W)
+#endif
+
+static void gfxIdentity(m4f M)
+{
+#if GFX_SIMD
+    _mm_storeu_ps(&M[4*0], _mm_setr_ps(1.0f, 0.0f, 0.0f, 0.0f));
+    _mm_storeu_ps(&M[4*1], _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f));
+    _mm_storeu_ps(&M[4*2], _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f));
+    _mm_storeu_ps(&M[4*3], _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+#else
+    for(u32 Idx = 0; Idx < 16; Idx++)
+    {
+        M[Idx] = (Idx % 5 == 0) ? 1.0f : 0.0f;
+    }
+#endif
+}
+
+static void gfxMulScalar(m4f R, const m4f A, const m4f B)
+{
+    m4f T;
+    for(u32 Col = 0; Col < 4; Col++)
+    {
+        for(u32 Row = 0; Row < 4; Row++)
+        {
+            T[4*Col+Row] = A[4*0+Row] * B[4*Col+0] +
+                           A[4*1+Row] * B[4*Col+1] +
+                           A[4*2+Row] * B[4*Col+2] +
+                           A[4*3+Row] * B[4*Col+3];
+        }
+    }
+
+    memcpy(R, T, sizeof(T));
+}
+
+#if GFX_SIMD
+// NOTE: Column of A * B for a column V of B, its elements are broadcast in registers rather than loaded one by one
+static __m128 gfxMulColumn(__m128 A0, __m128 A1, __m128 A2, __m128 A3, __m128 V)
+{
+    __m128 X = _mm_mul_ps(A0, GFX_SWIZZLE(V, 0, 0, 0, 0));
+    __m128 Y = _mm_mul_ps(A1, GFX_SWIZZLE(V, 1, 1, 1, 1));
+    __m128 Z = _mm_mul_ps(A2, GFX_SWIZZLE(V, 2, 2, 2, 2));
+    __m128 W = _mm_mul_ps(A3, GFX_SWIZZLE(V, 3, 3, 3, 3));
+    return _mm_add_ps(_mm_add_ps(X, Y), _mm_add_ps(Z, W));
+}
+
+static void gfxMulSimd(m4f R, const m4f A, const m4f B)
+{
+#if defined(__AVX__)
+    // NOTE: Two columns of B per register, elements are broadcast within every 128-bit half
+    __m256 A0 = _mm256_broadcast_ps((const __m128*) &A[4*0]);
+    __m256 A1 = _mm256_broadcast_ps((const __m128*) &A[4*1]);
+    __m256 A2 = _mm256_broadcast_ps((const __m128*) &A[4*2]);
+    __m256 A3 = _mm256_broadcast_ps((const __m128*) &A[4*3]);
+    __m256 B01 = _mm256_loadu_ps(&B[4*0]);
+    __m256 B23 = _mm256_loadu_ps(&B[4*2]);
+
+    __m256 R01 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(A0, _mm256_permute_ps(B01, 0x00)),
+                                             _mm256_mul_ps(A1, _mm256_permute_ps(B01, 0x55))),
+                               _mm256_add_ps(_mm256_mul_ps(A2, _mm256_permute_ps(B01, 0xAA)),
+                                             _mm256_mul_ps(A3, _mm256_permute_ps(B01, 0xFF))));
+    __m256 R23 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(A0, _mm256_permute_ps(B23, 0x00)),
+                                             _mm256_mul_ps(A1, _mm256_permute_ps(B23, 0x55))),
+                               _mm256_add_ps(_mm256_mul_ps(A2, _mm256_permute_ps(B23, 0xAA)),
+                                             _mm256_mul_ps(A3, _mm256_permute_ps(B23, 0xFF))));
+    _mm256_storeu_ps(&R[4*0], R01);
+    _mm256_storeu_ps(&R[4*2], R23);
+#else
+    __m128 A0 = _mm_loadu_ps(&A[4*0]);
+    __m128 A1 = _mm_loadu_ps(&A[4*1]);
+    __m128 A2 = _mm_loadu_ps(&A[4*2]);
+    __m128 A3 = _mm_loadu_ps(&A[4*3]);
+
+    // NOTE: Columns of B are loaded before any store, so R may alias A or B
+    __m128 B0 = _mm_loadu_ps(&B[4*0]);
+    __m128 B1 = _mm_loadu_ps(&B[4*1]);
+    __m128 B2 = _mm_loadu_ps(&B[4*2]);
+    __m128 B3 = _mm_loadu_ps(&B[4*3]);
+
+    _mm_storeu_ps(&R[4*0], gfxMulColumn(A0, A1, A2, A3, B0));
+    _mm_storeu_ps(&R[4*1], gfxMulColumn(A0, A1, A2, A3, B1));
+    _mm_storeu_ps(&R[4*2], gfxMulColumn(A0, A1, A2, A3, B2));
+    _mm_storeu_ps(&R[4*3], gfxMulColumn(A0, A1, A2, A3, B3));
+#endif
+}
+#endif
+
+static void gfxTransposeScalar(m4f R, const m4f M)
+{
+    m4f T;
+    for(u32 Col = 0; Col < 4; Col++)
+    {
+        for(u32 Row = 0; Row < 4; Row++)
+        {
+            T[4*Row+Col] = M[4*Col+Row];
+        }
+    }
+
+    memcpy(R, T, sizeof(T));
+}
+
+#if GFX_SIMD
+static void gfxTransposeSimd(m4f R, const m4f M)
+{
+    __m128 C0 = _mm_loadu_ps(&M[4*0]);
+    __m128 C1 = _mm_loadu_ps(&M[4*1]);
+    __m128 C2 = _mm_loadu_ps(&M[4*2]);
+    __m128 C3 = _mm_loadu_ps(&M[4*3]);
+    _MM_TRANSPOSE4_PS(C0, C1, C2, C3);
+    _mm_storeu_ps(&R[4*0], C0);
+    _mm_storeu_ps(&R[4*1], C1);
+    _mm_storeu_ps(&R[4*2], C2);
+    _mm_storeu_ps(&R[4*3], C3);
+}
+#endif
+
+// NOTE: Laplace expansion over 2x2 minors of the first and last two columns, returns 0 for singular matrices
+static b32 gfxInverseScalar(m4f R, const m4f M)
+{
+    f32 A00 = M[0],  A01 = M[1],  A02 = M[2],  A03 = M[3];
+    f32 A10 = M[4],  A11 = M[5],  A12 = M[6],  A13 = M[7];
+    f32 A20 = M[8],  A21 = M[9],  A22 = M[10], A23 = M[11];
+    f32 A30 = M[12], A31 = M[13], A32 = M[14], A33 = M[15];
+
+    f32 S0 = A00 * A11 - A10 * A01;
+    f32 S1 = A00 * A12 - A10 * A02;
+    f32 S2 = A00 * A13 - A10 * A03;
+    f32 S3 = A01 * A12 - A11 * A02;
+    f32 S4 = A01 * A13 - A11 * A03;
+    f32 S5 = A02 * A13 - A12 * A03;
+
+    f32 C5 = A22 * A33 - A32 * A23;
+    f32 C4 = A21 * A33 - A31 * A23;
+    f32 C3 = A21 * A32 - A31 * A22;
+    f32 C2 = A20 * A33 - A30 * A23;
+    f32 C1 = A20 * A32 - A30 * A22;
+    f32 C0 = A20 * A31 - A30 * A21;
+
+    f32 Det = S0 * C5 - S1 * C4 + S2 * C3 + S3 * C2 - S4 * C1 + S5 * C0;
+    if(Det == 0.0f)
+    {
+        return 0;
+    }
+
+    f32 InvDet = 1.0f / Det;
+
+    R[0]  = ( A11 * C5 - A12 * C4 + A13 * C3) * InvDet;
+    R[1]  = (-A01 * C5 + A02 * C4 - A03 * C3) * InvDet;
+    R[2]  = ( A31 * S5 - A32 * S4 + A33 * S3) * InvDet;
+    R[3]  = (-A21 * S5 + A22 * S4 - A23 * S3) * InvDet;
+
+    R[4]  = (-A10 * C5 + A12 * C2 - A13 * C1) * InvDet;
+    R[5]  = ( A00 * C5 - A02 * C2 + A03 * C1) * InvDet;
+    R[6]  = (-A30 * S5 + A32 * S2 - A33 * S1) * InvDet;
+    R[7]  = ( A20 * S5 - A22 * S2 + A23 * S1) * InvDet;
+
+    R[8]  = ( A10 * C4 - A11 * C2 + A13 * C0) * InvDet;
+    R[9]  = (-A00 * C4 + A01 * C2 - A03 * C0) * InvDet;
+    R[10] = ( A30 * S4 - A31 * S2 + A33 * S0) * InvDet;
+    R[11] = (-A20 * S4 + A21 * S2 - A23 * S0) * InvDet;
+
+    R[12] = (-A10 * C3 + A11 * C1 - A12 * C0) * InvDet;
+    R[13] = ( A00 * C3 - A01 * C1 + A02 * C0) * InvDet;
+    R[14] = (-A30 * S3 + A31 * S1 - A32 * S0) * InvDet;
+    R[15] = ( A20 * S3 - A21 * S1 + A22 * S0) * InvDet;
+
+    return 1;
+}
+
+#if GFX_SIMD
+// NOTE: 2x2 blocks are stored as (X Y Z W) for | X Y |
+//                                              | Z W |
+static __m128 gfxMat2Mul(__m128 A, __m128 B)
+{
+    return _mm_add_ps(_mm_mul_ps(A, GFX_SWIZZLE(B, 0, 3, 0, 3)),
+                      _mm_mul_ps(GFX_SWIZZLE(A, 1, 0, 3, 2), GFX_SWIZZLE(B, 2, 1, 2, 1)));
+}
+
+// NOTE: Adjugate of A times B
+static __m128 gfxMat2AdjMul(__m128 A, __m128 B)
+{
+    return _mm_sub_ps(_mm_mul_ps(GFX_SWIZZLE(A, 3, 3, 0, 0), B),
+                      _mm_mul_ps(GFX_SWIZZLE(A, 1, 1, 2, 2), GFX_SWIZZLE(B, 2, 3, 0, 1)));
+}
+
+// NOTE: A times adjugate of B
+static __m128 gfxMat2MulAdj(__m128 A, __m128 B)
+{
+    return _mm_sub_ps(_mm_mul_ps(A, GFX_SWIZZLE(B, 3, 0, 3, 0)),
+                      _mm_mul_ps(GFX_SWIZZLE(A, 1, 0, 3, 2), GFX_SWIZZLE(B, 2, 1, 2, 1)));
+}
+
+// NOTE: Block inverse with 2x2 adjugates, memory is read as rows, which is fine since inv(M^T) = inv(M)^T
+static b32 gfxInverseSimd(m4f R, const m4f M)
+{
+    __m128 R0 = _mm_loadu_ps(&M[4*0]);
+    __m128 R1 = _mm_loadu_ps(&M[4*1]);
+    __m128 R2 = _mm_loadu_ps(&M[4*2]);
+    __m128 R3 = _mm_loadu_ps(&M[4*3]);
+
+    __m128 A = _mm_movelh_ps(R0, R1);
+    __m128 B = _mm_movehl_ps(R1, R0);
+    __m128 C = _mm_movelh_ps(R2, R3);
+    __m128 D = _mm_movehl_ps(R3, R2);
+
+    // NOTE: (|A| |B| |C| |D|)
+    __m128 DetSub = _mm_sub_ps(_mm_mul_ps(GFX_SHUFFLE(R0, R2, 0, 2, 0, 2), GFX_SHUFFLE(R1, R3, 1, 3, 1, 3)),
+                               _mm_mul_ps(GFX_SHUFFLE(R0, R2, 1, 3, 1, 3), GFX_SHUFFLE(R1, R3, 0, 2, 0, 2)));
+    __m128 DetA = GFX_SWIZZLE(DetSub, 0, 0, 0, 0);
+    __m128 DetB = GFX_SWIZZLE(DetSub, 1, 1, 1, 1);
+    __m128 DetC = GFX_SWIZZLE(DetSub, 2, 2, 2, 2);
+    __m128 DetD = GFX_SWIZZLE(DetSub, 3, 3, 3, 3);
+
+    __m128 DC = gfxMat2AdjMul(D, C);
+    __m128 AB = gfxMat2AdjMul(A, B);
+
+    __m128 X = _mm_sub_ps(_mm_mul_ps(DetD, A), gfxMat2Mul(B, DC));
+    __m128 W = _mm_sub_ps(_mm_mul_ps(DetA, D), gfxMat2Mul(C, AB));
+    __m128 Y = _mm_sub_ps(_mm_mul_ps(DetB, C), gfxMat2MulAdj(D, AB));
+    __m128 Z = _mm_sub_ps(_mm_mul_ps(DetC, B), gfxMat2MulAdj(A, DC));
+
+    // NOTE: |M| = |A||D| + |B||C| - tr(A#B D#C)
+    __m128 Tr = _mm_mul_ps(AB, GFX_SWIZZLE(DC, 0, 2, 1, 3));
+    Tr = _mm_add_ps(Tr, GFX_SWIZZLE(Tr, 2, 3, 0, 1));
+    Tr = _mm_add_ps(Tr, GFX_SWIZZLE(Tr, 1, 0, 3, 2));
+    __m128 Det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(DetA, DetD), _mm_mul_ps(DetB, DetC)), Tr);
+    if(_mm_cvtss_f32(Det) == 0.0f)
+    {
+        return 0;
+    }
+
+    __m128 InvDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), Det);
+    X = _mm_mul_ps(X, InvDet);
+    Y = _mm_mul_ps(Y, InvDet);
+    Z = _mm_mul_ps(Z, InvDet);
+    W = _mm_mul_ps(W, InvDet);
+
+    // NOTE: Adjugate of every block folded into the store shuffle
+    _mm_storeu_ps(&R[4*0], GFX_SHUFFLE(X, Y, 3, 1, 3, 1));
+    _mm_storeu_ps(&R[4*1], GFX_SHUFFLE(X, Y, 2, 0, 2, 0));
+    _mm_storeu_ps(&R[4*2], GFX_SHUFFLE(Z, W, 3, 1, 3, 1));
+    _mm_storeu_ps(&R[4*3], GFX_SHUFFLE(Z, W, 2, 0, 2, 0));
+
+    return 1;
+}
+#endif
+
+static void gfxTransformV4(v4f R, const m4f M, const v4f V)
+{
+#if GFX_SIMD
+    __m128 X = _mm_mul_ps(_mm_loadu_ps(&M[4*0]), _mm_set1_ps(V[0]));
+    __m128 Y = _mm_mul_ps(_mm_loadu_ps(&M[4*1]), _mm_set1_ps(V[1]));
+    __m128 Z = _mm_mul_ps(_mm_loadu_ps(&M[4*2]), _mm_set1_ps(V[2]));
+    __m128 W = _mm_mul_ps(_mm_loadu_ps(&M[4*3]), _mm_set1_ps(V[3]));
+    _mm_storeu_ps(R, _mm_add_ps(_mm_add_ps(X, Y), _mm_add_ps(Z, W)));
+#else
+    f32 X = V[0], Y = V[1], Z = V[2], W = V[3];
+    for(u32 Row = 0; Row < 4; Row++)
+    {
+        R[Row] = M[4*0+Row] * X + M[4*1+Row] * Y + M[4*2+Row] * Z + M[4*3+Row] * W;
+    }
+#endif
+}
+
+// NOTE: Transforms 2D points (X, Y, 0, 1) in place, Stride is in bytes so gfx_vtx arrays work too
+static void gfxTransformPointsScalar(const m4f M, f32* Points, usz Count, usz Stride)
+{
+    u8* At = (u8*) Points;
+    for(usz Idx = 0; Idx < Count; Idx++, At += Stride)
+    {
+        f32* P = (f32*) At;
+        f32 X = P[0];
+        f32 Y = P[1];
+        P[0] = M[0] * X + M[4] * Y + M[12];
+        P[1] = M[1] * X + M[5] * Y + M[13];
+    }
+}
+
+#if GFX_SIMD
+static void gfxTransformPointsSimd(const m4f M, f32* Points, usz Count, usz Stride)
+{
+    usz Idx = 0;
+
+    // NOTE: Packed points go 2 per SSE register, (X0 Y0 X1 Y1) * (M0 M1 M0 M1) + (Y0 Y0 Y1 Y1) * ...
+    __m128 MX = _mm_setr_ps(M[0], M[1], M[0], M[1]);
+    __m128 MY = _mm_setr_ps(M[4], M[5], M[4], M[5]);
+    __m128 MT = _mm_setr_ps(M[12], M[13], M[12], M[13]);
+    if(Stride == 2 * sizeof(f32))
+    {
+#if defined(__AVX__)
+        __m256 MX8 = _mm256_set_m128(MX, MX);
+        __m256 MY8 = _mm256_set_m128(MY, MY);
+        __m256 MT8 = _mm256_set_m128(MT, MT);
+        for(; Idx + 4 <= Count; Idx += 4)
+        {
+            f32* P = Points + 2 * Idx;
+            __m256 V = _mm256_loadu_ps(P);
+            __m256 X = _mm256_moveldup_ps(V);
+            __m256 Y = _mm256_movehdup_ps(V);
+            _mm256_storeu_ps(P, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(X, MX8), _mm256_mul_ps(Y, MY8)), MT8));
+        }
+#endif
+
+        for(; Idx + 2 <= Count; Idx += 2)
+        {
+            f32* P = Points + 2 * Idx;
+            __m128 V = _mm_loadu_ps(P);
+            __m128 X = GFX_SWIZZLE(V, 0, 0, 2, 2);
+            __m128 Y = GFX_SWIZZLE(V, 1, 1, 3, 3);
+            _mm_storeu_ps(P, _mm_add_ps(_mm_add_ps(_mm_mul_ps(X, MX), _mm_mul_ps(Y, MY)), MT));
+        }
+    }
+
+    u8* At = (u8*) Points + Idx * Stride;
+    for(; Idx < Count; Idx++, At += Stride)
+    {
+        __m128 V = _mm_castpd_ps(_mm_load_sd((const double*) At));
+        __m128 X = GFX_SWIZZLE(V, 0, 0, 0, 0);
+        __m128 Y = GFX_SWIZZLE(V, 1, 1, 1, 1);
+        _mm_store_sd((double*) At, _mm_castps_pd(_mm_add_ps(_mm_add_ps(_mm_mul_ps(X, MX), _mm_mul_ps(Y, MY)), MT)));
+    }
+}
+#endif
+
+// NOTE: Picked after --bench-math at -O2, the SSE point transform only ties with the scalar loop and is
+// used once AVX doubles its width
+#if GFX_SIMD
+#define gfxMul gfxMulSimd
+#define gfxTranspose gfxTransposeSimd
+#define gfxInverse gfxInverseSimd
+#if defined(__AVX__)
+#define gfxTransformPoints gfxTransformPointsSimd
+#else
+#define gfxTransformPoints gfxTransformPointsScalar
+#endif
+#else
+#define gfxMul gfxMulScalar
+#define gfxTranspose gfxTransposeScalar
+#define gfxInverse gfxInverseScalar
+#define gfxTransformPoints gfxTransformPointsScalar
+#endif
+
+// NOTE: Translations and scales post-multiply like glTranslatef and glScalef, M = M * T
+static void gfxTranslate(m4f M, v3f V)
+{
+#if GFX_SIMD
+    __m128 C0 = _mm_mul_ps(_mm_loadu_ps(&M[4*0]), _mm_set1_ps(V[0]));
+    __m128 C1 = _mm_mul_ps(_mm_loadu_ps(&M[4*1]), _mm_set1_ps(V[1]));
+    __m128 C2 = _mm_mul_ps(_mm_loadu_ps(&M[4*2]), _mm_set1_ps(V[2]));
+    __m128 C3 = _mm_loadu_ps(&M[4*3]);
+    _mm_storeu_ps(&M[4*3], _mm_add_ps(_mm_add_ps(C0, C1), _mm_add_ps(C2, C3)));
+#else
+    for(u32 Row = 0; Row < 4; Row++)
+    {
+        M[4*3+Row] = (M[4*0+Row] * V[0] + M[4*1+Row] * V[1]) + (M[4*2+Row] * V[2] + M[4*3+Row]);
+    }
+#endif
+}
+
+static void gfxTranslateX(m4f M, f32 X)
+{
+    v3f V = {X, 0.0f, 0.0f};
+    gfxTranslate(M, V);
+}
+
+static void gfxTranslateY(m4f M, f32 Y)
+{
+    v3f V = {0.0f, Y, 0.0f};
+    gfxTranslate(M, V);
+}
+
+static void gfxTranslateZ(m4f M, f32 Z)
+{
+    v3f V = {0.0f, 0.0f, Z};
+    gfxTranslate(M, V);
+}
+
+static void gfxScaleX(m4f M, f32 X)
+{
+#if GFX_SIMD
+    _mm_storeu_ps(&M[4*0], _mm_mul_ps(_mm_loadu_ps(&M[4*0]), _mm_set1_ps(X)));
+#else
+    for(u32 Row = 0; Row < 4; Row++)
+    {
+        M[4*0+Row] *= X;
+    }
+#endif
+}
+
+static void gfxScaleY(m4f M, f32 Y)
+{
+#if GFX_SIMD
+    _mm_storeu_ps(&M[4*1], _mm_mul_ps(_mm_loadu_ps(&M[4*1]), _mm_set1_ps(Y)));
+#else
+    for(u32 Row = 0; Row < 4; Row++)
+    {
+        M[4*1+Row] *= Y;
+    }
+#endif
+}
+
+static void gfxScaleZ(m4f M, f32 Z)
+{
+#if GFX_SIMD
+    _mm_storeu_ps(&M[4*2], _mm_mul_ps(_mm_loadu_ps(&M[4*2]), _mm_set1_ps(Z)));
+#else
+    for(u32 Row = 0; Row < 4; Row++)
+    {
+        M[4*2+Row] *= Z;
+    }
+#endif
+}
+
+static void gfxScale(m4f M, v3f V)
+{
+    gfxScaleX(M, V[0]);
+    gfxScaleY(M, V[1]);
+    gfxScaleZ(M, V[2]);
+}
+
+static void gfxOrtho(f32* M, f32 Left, f32 Right, f32 Bottom, f32 Top, f32 Near, f32 Far)
+{
+    M[0]  = 2.0f / (Right - Left);
+    M[1]  = 0.0f;
+    M[2]  = 0.0f;
+    M[3]  = 0.0f;
+
+    M[4]  = 0.0f;
+    M[5]  = 2.0f / (Top - Bottom);
+    M[6]  = 0.0f;
+    M[7]  = 0.0f;
+
+    M[8]  = 0.0f;
+    M[9]  = 0.0f;
+    M[10] = -2.0f / (Far - Near);
+    M[11] = 0.0f;
+
+    M[12] = -(Right + Left) / (Right - Left);
+    M[13] = -(Top + Bottom) / (Top - Bottom);
+    M[14] = -(Far + Near) / (Far - Near);
+    M[15] = 1.0f;
+}
+
+typedef struct
+{
+    f32 X;
+    f32 Y;
+    f32 U;
+    f32 V;
+    u32 Color; // R, G, B, A bytes
+} gfx_vtx;
+
+typedef struct
+{
+    u32 Texture;
+    u32 First;
+    u32 Count;
+    i32 Clip[4]; // Scissor X1 Y1 X2 Y2 in pixels, origin in the top-left corner
+} gfx_cmd;
+
+typedef struct
+{
+    u32 Code; // Codepoint
+    u32 Fg; // Same byte order as gfx_vtx.Color
+    u32 Bg; // Zero leaves the cell transparent
+} gfx_cell;
+
+// NOTE: Cells are owned by the application and drawn with font cell size. Rows are stored as a ring starting
+// at Top, so scrolling rewrites only the rows that come in. Cells written directly, not with gfxGridText, must be
+// reported with gfxGridDirty, so that the copies below are updated.
+typedef struct
+{
+    u32 Cols;
+    u32 Rows;
+    gfx_cell* Cells; // Cols*Rows cells, row after row
+    u32 Top; // Stored row of the first drawn row
+    u32 Dirty[4]; // Stored cells changed since the last draw, Col1 Row1 Col2 Row2, empty when Col1 >= Col2
+    u32 Texture; // Slot, Fg and Bg of every cell in a GL_RGB32UI texture, kept by the core backend
+    u32 TexCols;
+    u32 TexRows;
+    u32* Pixels; // Rasterized cells in stored order, kept by the software backend
+    u32 PixelCols;
+    u32 PixelRows;
+} gfx_grid;
+
+#define GFX_DRAW_VTX 0x10000
+#define GFX_DRAW_IDX (3 * GFX_DRAW_VTX)
+#define GFX_DRAW_CMD 256
+
+typedef struct gfx_draw
+{
+    u32 VtxCount;
+    u32 IdxCount;
+    u32 CmdCount;
+    gfx_vtx* Vtx; // GFX_DRAW_VTX entries
+    u16* Idx; // GFX_DRAW_IDX entries
+    gfx_cmd* Cmd; // GFX_DRAW_CMD entries
+    struct gfx_draw* Next; // Further popup lists in the frame arena
+} gfx_draw;
+
+static gfx_draw GfxDraw;
+static gfx_draw GfxPopupDraw; // Drawn by gfxEndFrame, above everything else, never flushed before
+static gfx_draw* GfxTarget = &GfxDraw;
+static u32 GfxColor = 0xFFFFFFFF;
+static gfx_fnt GfxFnt;
+static f32 GfxSep = 20.f;
+static v2f GfxPos = {0.0f, 0.0f};
+static v2f GfxCur = {0.0f, 0.0f};
+static b32 GfxBtn = 0;
+static f32 GfxCols;
+static f32 GfxRows;
+typedef u32 gfx_id; // Hash of a widget label or value within the ID scopes, 0 is no widget
+
+static gfx_id GfxHot = 0;
+static gfx_id GfxPrevHot = 0;
+static u8 GfxKeyLeft;
+static u8 GfxKeyRight;
+static u8 GfxKeyUp;
+static u8 GfxKeyDown;
+static u8 GfxKeyShift;
+static i8 GfxWheel; // Wheel notches of the frame, positive away from the user
+
+#define GFX_STACK_DEPTH 32
+
+typedef struct
+{
+    i32 Clip[4]; // X1 Y1 X2 Y2 in pixels of the screen
+    v2f Offset; // Added to every coordinate given to the drawing functions
+} gfx_state;
+
+static gfx_state GfxState;
+static gfx_state GfxStack[GFX_STACK_DEPTH];
+static u32 GfxStackCount;
+static u32 GfxLayer; // 0 for regular widgets, 1 between gfxBeginPopup and gfxEndPopup
+
+#define GFX_STATS_FRAMES 128
+
+typedef struct
+{
+    u32 DrawCalls;
+    u32 Vertices;
+    u32 Binds;
+    u32 Glyphs;
+} gfx_stats;
+
+static gfx_stats GfxStats; // Counters of the frame being built
+static gfx_stats GfxStatsLast; // Counters of the previous, complete frame
+static f32 GfxFrameMs[GFX_STATS_FRAMES]; // Work of complete frames in milliseconds, indexed by GfxFrame
+static u64 GfxFrameStart; // Clock at the start of the current frame
+
+static f64 GfxTime; // Seconds since the first frame, at the start of the current frame
+static f32 GfxDelta; // Seconds since the previous frame
+static u64 GfxFrame; // Index of the current frame, the first one is 0
+static b32 GfxClockStarted;
+static u64 GfxClockLast;
+
+#define GFX_DELTA_MAX 0.25f
+
+// NOTE: Advances the frame clock by a given delta, used directly for fixed steps and replays
+static void gfxStepFrame(f32 Delta)
+{
+    if(GfxClockStarted)
+    {
+        GfxFrame++;
+        GfxDelta = Delta;
+        GfxTime += Delta;
+    }
+    else
+    {
+        GfxClockStarted = 1;
+        GfxFrame = 0;
+        GfxDelta = 0.0f;
+        GfxTime = 0.0;
+    }
+
+    GfxStatsLast = GfxStats;
+    memset(&GfxStats, 0, sizeof(GfxStats));
+    GfxFrameStart = gfxClock();
+
+    GFX_TRACE_FRAME(GfxFrame);
+}
+
+// NOTE: Called by the platform layer before AppUpdate
+static void gfxNewFrame(void)
+{
+    u64 Now = gfxClock();
+
+    // NOTE: Long stalls, like an idle sleep or a debugger break, do not jump animations ahead
+    f32 Delta = 0.0f;
+    if(GfxClockLast)
+    {
+        Delta = Min((Now - GfxClockLast) / 1000000000.0f, GFX_DELTA_MAX);
+    }
+
+    GfxClockLast = Now;
+    gfxStepFrame(Delta);
+}
+
+#define GFX_WAIT_FOREVER 0xFFFFFFFF
+
+static u32 GfxWaitMs = GFX_WAIT_FOREVER;
+
+// NOTE: Asks the platform layer for another frame within Ms milliseconds, 0 means as soon as possible
+static void gfxRequestFrame(u32 Ms)
+{
+    GfxWaitMs = Min(GfxWaitMs, Ms);
+}
+
+// NOTE: Called by the platform layer after AppUpdate, how long it may sleep waiting for input
+static u32 gfxFrameWait(void)
+{
+    u32 Result = GfxWaitMs;
+    GfxWaitMs = GFX_WAIT_FOREVER;
+    return Result;
+}
+
+static u32 gfxUtf8Next(const char* Text, usz Size, usz* Idx)
+{
+    const u8* At = (const u8*) Text + *Idx;
+    usz Left = Size - *Idx;
+
+    u32 Code = At[0];
+    u32 Count = 1;
+    if(Code < 0x80)
+    {
+        // NOTE: ASCII
+    }
+    else if((Code & 0xE0) == 0xC0 && Left >= 2 && (At[1] & 0xC0) == 0x80)
+    {
+        Code = ((Code & 0x1F) << 6) | (At[1] & 0x3F);
+        Count = (Code >= 0x80) ? 2 : 0;
+    }
+    else if((Code & 0xF0) == 0xE0 && Left >= 3 && (At[1] & 0xC0) == 0x80 && (At[2] & 0xC0) == 0x80)
+    {
+        Code = ((Code & 0x0F) << 12) | ((At[1] & 0x3F) << 6) | (At[2] & 0x3F);
+        Count = (Code >= 0x800) ? 3 : 0;
+    }
+    else if((Code & 0xF8) == 0xF0 && Left >= 4 && (At[1] & 0xC0) == 0x80 && (At[2] & 0xC0) == 0x80 && (At[3] & 0xC0) == 0x80)
+    {
+        Code = ((Code & 0x07) << 18) | ((At[1] & 0x3F) << 12) | ((At[2] & 0x3F) << 6) | (At[3] & 0x3F);
+        Count = (Code >= 0x10000 && Code < 0x110000) ? 4 : 0;
+    }
+    else
+    {
+        Count = 0;
+    }
+
+    if(!Count)
+    {
+        Code = 0xFFFD;
+        Count = 1;
+    }
+
+    *Idx += Count;
+
+    return Code;
+}
+
+static usz gfxTextCols(const char* Text, usz Size)
+{
+    usz Result = 0;
+
+    for(usz Idx = 0; Idx < Size;)
+    {
+        gfxUtf8Next(Text, Size, &Idx);
+        Result++;
+    }
+
+    return Result;
+}
+
+#if GFX_GL
+
+typedef struct
+{
+    GLuint Vao;
+    GLuint Vbo;
+    GLuint Ibo;
+    GLuint Program;
+    GLint Proj;
+
+    GLuint GridVao; // No attributes, corners come from gl_VertexID
+    GLuint GridProgram;
+    GLint GridProj;
+    GLint GridRect;
+    GLint GridCell;
+    GLint GridGlyph;
+    GLint GridTop;
+} gfx_core;
+
+static gfx_core GfxCore;
+
+static const char* GfxCoreVert =
+    "#version 330 core\n"
+    "layout(location = 0) in vec2 Pos;\n"
+    "layout(location = 1) in vec2 Uv;\n"
+    "layout(location = 2) in vec4 Color;\n"
+    "uniform mat4 Proj;\n"
+    "out vec2 FragUv;\n"
+    "out vec4 FragColor;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_Position = Proj * vec4(Pos, 0.0, 1.0);\n"
+    "    FragUv = Uv;\n"
+    "    FragColor = Color;\n"
+    "}\n";
+
+static const char* GfxCoreFrag =
+    "#version 330 core\n"
+    "uniform sampler2D Tex;\n"
+    "in vec2 FragUv;\n"
+    "in vec4 FragColor;\n"
+    "out vec4 OutColor;\n"
+    "void main()\n"
+    "{\n"
+    "    OutColor = FragColor * texture(Tex, FragUv);\n"
+    "}\n";
+
+static const char* GfxGridVert =
+    "#version 330 core\n"
+    "uniform mat4 Proj;\n"
+    "uniform vec4 Rect;\n"
+    "void main()\n"
+    "{\n"
+    "    vec2 Corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);\n"
+    "    gl_Position = Proj * vec4(mix(Rect.xy, Rect.zw, Corner), 0.0, 1.0);\n"
+    "}\n";
+
+// NOTE: Every fragment looks up its cell, then the glyph texel of the cell, colors are premultiplied. Exact pixel
+// centers from gl_FragCoord sample the glyph like the software backend does.
+static const char* GfxGridFrag =
+    "#version 330 core\n"
+    "uniform usampler2D Cells;\n"
+    "uniform sampler2D Atlas;\n"
+    "uniform vec4 Rect;\n"
+    "uniform vec2 Cell;\n"
+    "uniform ivec3 Glyph;\n"
+    "uniform int Top;\n"
+    "layout(origin_upper_left) in vec4 gl_FragCoord;\n"
+    "out vec4 OutColor;\n"
+    "vec4 Unpack(uint Color)\n"
+    "{\n"
+    "    return vec4((uvec4(Color) >> uvec4(0u, 8u, 16u, 24u)) & 0xFFu) / 255.0;\n"
+    "}\n"
+    "void main()\n"
+    "{\n"
+    "    vec2 Local = (gl_FragCoord.xy - Rect.xy) / Cell;\n"
+    "    ivec2 At = ivec2(Local);\n"
+    "    At.y = (At.y + Top) % textureSize(Cells, 0).y;\n"
+    "    uvec3 Data = texelFetch(Cells, At, 0).rgb;\n"
+    "    int Slot = int(Data.r);\n"
+    "    ivec2 Texel = ivec2(Slot % Glyph.x, Slot / Glyph.x) * Glyph.yz + ivec2(fract(Local) * vec2(Glyph.yz));\n"
+    "    float Cover = texelFetch(Atlas, Texel, 0).r;\n"
+    "    OutColor = mix(Unpack(Data.b), Unpack(Data.g), Cover);\n"
+    "}\n";
+
+static GLuint gfxCoreShader(GLenum Type, const char* Source)
+{
+    GLuint Shader = glCreateShader(Type);
+    glShaderSource(Shader, 1, &Source, 0);
+    glCompileShader(Shader);
+
+    GLint Compiled = 0;
+    glGetShaderiv(Shader, GL_COMPILE_STATUS, &Compiled);
+    if(!Compiled)
+    {
+        char Log[1024];
+        glGetShaderInfoLog(Shader, sizeof(Log), 0, Log);
+        gfxDebug("Shader compilation failed: %s\n", Log);
+        glDeleteShader(Shader);
+        Shader = 0;
+    }
+
+    return Shader;
+}
+
+static GLuint gfxCoreProgram(const char* VertSource, const char* FragSource)
+{
+    GLuint Vert = gfxCoreShader(GL_VERTEX_SHADER, VertSource);
+    GLuint Frag = gfxCoreShader(GL_FRAGMENT_SHADER, FragSource);
+    if(!Vert || !Frag)
+    {
+        return 0;
+    }
+
+    GLuint Program = glCreateProgram();
+    glAttachShader(Program, Vert);
+    glAttachShader(Program, Frag);
+    glLinkProgram(Program);
+    glDeleteShader(Vert);
+    glDeleteShader(Frag);
+
+    GLint Linked = 0;
+    glGetProgramiv(Program, GL_LINK_STATUS, &Linked);
+    if(!Linked)
+    {
+        char Log[1024];
+        glGetProgramInfoLog(Program, sizeof(Log), 0, Log);
+        gfxDebug("Program linking failed: %s\n", Log);
+        return 0;
+    }
+
+    return Program;
+}
+
+static b32 gfxCoreInit(void)
+{
+#define X(Type, Name) \
+    if(!(Name = (Type) gfxGlGetProcAddress(#Name))) \
+    { \
+        gfxDebug("Missing %s\n", #Name); \
+        return 0; \
+    }
+    GFX_GL_CORE_PROCS
+    GFX_GL_LEGACY_PROCS
+#undef X
+
+    gfx_core* Core = &GfxCore;
+
+    Core->Program = gfxCoreProgram(GfxCoreVert, GfxCoreFrag);
+    Core->GridProgram = gfxCoreProgram(GfxGridVert, GfxGridFrag);
+    if(!Core->Program || !Core->GridProgram)
+    {
+        return 0;
+    }
+
+    Core->Proj = glGetUniformLocation(Core->Program, "Proj");
+    glUseProgram(Core->Program);
+    glUniform1i(glGetUniformLocation(Core->Program, "Tex"), 0);
+
+    Core->GridProj = glGetUniformLocation(Core->GridProgram, "Proj");
+    Core->GridRect = glGetUniformLocation(Core->GridProgram, "Rect");
+    Core->GridCell = glGetUniformLocation(Core->GridProgram, "Cell");
+    Core->GridGlyph = glGetUniformLocation(Core->GridProgram, "Glyph");
+    Core->GridTop = glGetUniformLocation(Core->GridProgram, "Top");
+    glUseProgram(Core->GridProgram);
+    glUniform1i(glGetUniformLocation(Core->GridProgram, "Atlas"), 0);
+    glUniform1i(glGetUniformLocation(Core->GridProgram, "Cells"), 1);
+    glUseProgram(0);
+
+    glGenVertexArrays(1, &Core->GridVao);
+
+    glGenVertexArrays(1, &Core->Vao);
+    glGenBuffers(1, &Core->Vbo);
+    glGenBuffers(1, &Core->Ibo);
+
+    glBindVertexArray(Core->Vao);
+    glBindBuffer(GL_ARRAY_BUFFER, Core->Vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, Core->Ibo);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(gfx_vtx), (void*) offsetof(gfx_vtx, X));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(gfx_vtx), (void*) offsetof(gfx_vtx, U));
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(gfx_vtx), (void*) offsetof(gfx_vtx, Color));
+    glBindVertexArray(0);
+
+    return 1;
+}
+
+// NOTE: Commands differ in texture or clip, so only the changed one is set
+static void gfxGlState(gfx_draw* Draw, u32 Idx)
+{
+    gfx_cmd* Cmd = &Draw->Cmd[Idx];
+    gfx_cmd* Prev = Idx ? &Draw->Cmd[Idx-1] : 0;
+
+    if(!Prev || Prev->Texture != Cmd->Texture)
+    {
+        glBindTexture(GL_TEXTURE_2D, Cmd->Texture);
+        GfxStats.Binds++;
+    }
+
+    if(!Prev || memcmp(Prev->Clip, Cmd->Clip, sizeof(Cmd->Clip)) != 0)
+    {
+        // NOTE: Scissor origin is in the bottom-left corner
+        i32* Clip = Cmd->Clip;
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(Clip[0], (i32)GfxRows - Clip[3], Clip[2] - Clip[0], Clip[3] - Clip[1]);
+    }
+}
+
+static void gfxCoreFlush(gfx_draw* Draw, m4f Proj)
+{
+    gfx_core* Core = &GfxCore;
+
+    glUseProgram(Core->Program);
+    glUniformMatrix4fv(Core->Proj, 1, GL_FALSE, Proj);
+    glBindVertexArray(Core->Vao);
+
+    // NOTE: Orphan the buffers so the driver does not wait for the previous flush
+    glBindBuffer(GL_ARRAY_BUFFER, Core->Vbo);
+    glBufferData(GL_ARRAY_BUFFER, GFX_DRAW_VTX * sizeof(gfx_vtx), 0, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, Draw->VtxCount * sizeof(gfx_vtx), Draw->Vtx);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, GFX_DRAW_IDX * sizeof(u16), 0, GL_STREAM_DRAW);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, Draw->IdxCount * sizeof(u16), Draw->Idx);
+
+    for(u32 Idx = 0; Idx < Draw->CmdCount; Idx++)
+    {
+        gfx_cmd* Cmd = &Draw->Cmd[Idx];
+        gfxGlState(Draw, Idx);
+        glDrawElements(GL_TRIANGLES, Cmd->Count, GL_UNSIGNED_SHORT, (void*) (Cmd->First * sizeof(u16)));
+    }
+
+    GfxStats.DrawCalls += Draw->CmdCount;
+
+    glDisable(GL_SCISSOR_TEST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
+
+static void gfxCompatFlush(gfx_draw* Draw, m4f Proj)
+{
+    glMatrixMode(GL_PROJECTION);
+    glLoadMatrixf(Proj);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, sizeof(gfx_vtx), &Draw->Vtx[0].X);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(gfx_vtx), &Draw->Vtx[0].U);
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(gfx_vtx), &Draw->Vtx[0].Color);
+
+    for(u32 Idx = 0; Idx < Draw->CmdCount; Idx++)
+    {
+        gfx_cmd* Cmd = &Draw->Cmd[Idx];
+        gfxGlState(Draw, Idx);
+        glDrawElements(GL_TRIANGLES, Cmd->Count, GL_UNSIGNED_SHORT, Draw->Idx + Cmd->First);
+    }
+
+    GfxStats.DrawCalls += Draw->CmdCount;
+
+    glDisable(GL_SCISSOR_TEST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_COLOR_ARRAY);
+}
+
+// NOTE: Packs the stored cells of a rect, from the frame arena
+static u32* gfxCoreGridPack(gfx_grid* Grid, u32 Col1, u32 Row1, u32 Col2, u32 Row2)
+{
+    u32* Data = gfxArenaPush(GfxFrameArena, (usz)(Col2 - Col1) * (Row2 - Row1) * 3 * sizeof(u32));
+    u32* At = Data;
+    for(u32 Row = Row1; Row < Row2; Row++)
+    {
+        gfx_cell* Cell = Grid->Cells + (usz)Row * Grid->Cols + Col1;
+        for(u32 Col = Col1; Col < Col2; Col++, Cell++)
+        {
+            *At++ = gfxGlyph(&GfxFnt, Cell->Code);
+            *At++ = Cell->Fg;
+            *At++ = Cell->Bg;
+        }
+    }
+
+    return Data;
+}
+
+// NOTE: Uploads only the dirty cells, then one draw whatever is in them
+static void gfxCoreGrid(gfx_grid* Grid, f32 X, f32 Y, m4f Proj)
+{
+    gfx_core* Core = &GfxCore;
+    gfx_fnt* Fnt = &GfxFnt;
+
+    glActiveTexture(GL_TEXTURE1);
+    if(!Grid->Texture || Grid->TexCols != Grid->Cols || Grid->TexRows != Grid->Rows)
+    {
+        if(!Grid->Texture)
+        {
+            glGenTextures(1, &Grid->Texture);
+        }
+
+        u32* Data = gfxCoreGridPack(Grid, 0, 0, Grid->Cols, Grid->Rows);
+        glBindTexture(GL_TEXTURE_2D, Grid->Texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32UI, Grid->Cols, Grid->Rows, 0, GL_RGB_INTEGER, GL_UNSIGNED_INT, Data);
+        Grid->TexCols = Grid->Cols;
+        Grid->TexRows = Grid->Rows;
+    }
+    else
+    {
+        glBindTexture(GL_TEXTURE_2D, Grid->Texture);
+
+        u32* Dirty = Grid->Dirty;
+        if(Dirty[0] < Dirty[2])
+        {
+            u32* Data = gfxCoreGridPack(Grid, Dirty[0], Dirty[1], Dirty[2], Dirty[3]);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, Dirty[0], Dirty[1], Dirty[2] - Dirty[0], Dirty[3] - Dirty[1], GL_RGB_INTEGER, GL_UNSIGNED_INT, Data);
+        }
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, Fnt->Texture);
+
+    i32* Clip = GfxState.Clip;
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(Clip[0], (i32)GfxRows - Clip[3], Clip[2] - Clip[0], Clip[3] - Clip[1]);
+
+    glUseProgram(Core->GridProgram);
+    glUniformMatrix4fv(Core->GridProj, 1, GL_FALSE, Proj);
+    glUniform4f(Core->GridRect, X, Y, X + Grid->Cols * Fnt->Cols, Y + Grid->Rows * Fnt->Rows);
+    glUniform2f(Core->GridCell, (f32)Fnt->Cols, (f32)Fnt->Rows);
+    glUniform3i(Core->GridGlyph, Fnt->TexCols, Fnt->Width, Fnt->Height);
+    glUniform1i(Core->GridTop, Grid->Top);
+    glBindVertexArray(Core->GridVao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    GfxStats.DrawCalls++;
+    GfxStats.Binds += 2;
+    GfxStats.Vertices += 4;
+
+    glBindVertexArray(0);
+    glUseProgram(0);
+    glDisable(GL_SCISSOR_TEST);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+#endif
+
+//
+// SOFTWARE
+//
+
+typedef enum
+{
+    GFX_PRIM_RECT,
+    GFX_PRIM_TRIANGLE,
+    GFX_PRIM_GLYPH,
+    GFX_PRIM_IMAGE,
+    GFX_PRIM_CLEAR,
+    GFX_PRIM_GRID,
+} gfx_prim_kind;
+
+typedef struct
+{
+    u32 Kind;
+    u32 Color;
+    u32 Slot; // Glyph slot
+    f32 P[6]; // Rect X1 Y1 X2 Y2, or triangle X1 Y1 X2 Y2 X3 Y3
+    i32 Clip[4]; // Pixels X1 Y1 X2 Y2
+    union
+    {
+        gfx_img* Img;
+        gfx_grid* Grid;
+    };
+} gfx_prim;
+
+#define GFX_SOFT_PRIMS 0x10000
+#define GFX_SOFT_POPUP 0x1000
+#define GFX_SOFT_TILE 64 // Tile size in pixels, 64 pixels are 256 bytes of a row
+#define GFX_SOFT_THREADS 64
+
+typedef struct
+{
+    u32 Cols;
+    u32 Rows;
+    u32* Pixels; // Same byte order as gfx_vtx.Color
+    u32 PrimCount;
+    gfx_prim* Prims; // GFX_SOFT_PRIMS entries
+    u32 PopupCount;
+    u32 PopupCap;
+    gfx_prim* Popup; // In the frame arena, grows instead of being flushed before the end of the frame
+
+    u32 TileCols;
+    u32 TileRows;
+    u32 TileCount;
+    u32 TileCap;
+    u32* TileFirst; // Offset of every tile in Bins, TileCount+1 entries
+    u32* TileNext; // Fill cursor of every tile while binning
+    u32 BinCap;
+    u32* Bins; // Indices of the primitives touching every tile, in submission order
+    volatile u32 NextTile;
+
+    u32 ThreadCount; // Rasterizing threads, including the caller of gfxSoftFlush
+    u32 WorkerCount; // Started worker threads
+    gfx_thread Workers[GFX_SOFT_THREADS];
+    gfx_sem Work;
+    gfx_sem Done;
+} gfx_soft;
+
+static gfx_soft GfxSoft;
+
+static void gfxSoftTarget(u32* Pixels, u32 Cols, u32 Rows)
+{
+    gfx_soft* Soft = &GfxSoft;
+    Soft->Pixels = Pixels;
+    Soft->Cols = Cols;
+    Soft->Rows = Rows;
+    Soft->TileCols = (Cols + GFX_SOFT_TILE - 1) / GFX_SOFT_TILE;
+    Soft->TileRows = (Rows + GFX_SOFT_TILE - 1) / GFX_SOFT_TILE;
+    Soft->TileCount = Soft->TileCols * Soft->TileRows;
+    if(Soft->TileCount > Soft->TileCap)
+    {
+        if(Soft->TileFirst)
+        {
+            gfxVirtualFree(Soft->TileFirst);
+        }
+
+        Soft->TileCap = Soft->TileCount;
+        Assert(Soft->TileFirst = gfxVirtualAlloc(2 * (Soft->TileCap + 1) * sizeof(u32)));
+        Soft->TileNext = Soft->TileFirst + Soft->TileCap + 1;
+    }
+
+    GfxCols = (f32) Cols;
+    GfxRows = (f32) Rows;
+}
+
+// NOTE: Dst * (255 - Alpha) / 255 + Src, the same as glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA)
+#if GFX_SIMD
+static __m128i gfxSoftBlend(__m128i Dst, __m128i Src, __m128i InvAlpha)
+{
+    __m128i Zero = _mm_setzero_si128();
+    __m128i Bias = _mm_set1_epi16(128);
+    __m128i Lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(Dst, Zero), InvAlpha), Bias);
+    __m128i Hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(Dst, Zero), InvAlpha), Bias);
+    Lo = _mm_srli_epi16(_mm_add_epi16(Lo, _mm_srli_epi16(Lo, 8)), 8);
+    Hi = _mm_srli_epi16(_mm_add_epi16(Hi, _mm_srli_epi16(Hi, 8)), 8);
+    return _mm_adds_epu8(_mm_packus_epi16(Lo, Hi), Src);
+}
+#endif
+
+static void gfxSoftPixel(u32* At, u32 Color)
+{
+    u32 Alpha = Color >> 24;
+    if(Alpha == 255)
+    {
+        *At = Color;
+    }
+    else
+    {
+#if GFX_SIMD
+        __m128i InvAlpha = _mm_set1_epi16((i16)(255 - Alpha));
+        __m128i Dst = _mm_cvtsi32_si128((int)*At);
+        __m128i Src = _mm_cvtsi32_si128((int)Color);
+        *At = (u32) _mm_cvtsi128_si32(gfxSoftBlend(Dst, Src, InvAlpha));
+#else
+        u32 Dst = *At;
+        u32 Result = 0;
+        for(u32 Shift = 0; Shift < 32; Shift += 8)
+        {
+            u32 Value = ((Dst >> Shift) & 0xFF) * (255 - Alpha) + 128;
+            Value = ((Value + (Value >> 8)) >> 8) + ((Color >> Shift) & 0xFF);
+            Result |= Min(Value, 255u) << Shift;
+        }
+        *At = Result;
+#endif
+    }
+}
+
+static void gfxSoftFill(u32* Row, i32 X1, i32 X2, u32 Color)
+{
+    u32* At = Row + X1;
+    i32 Count = X2 - X1;
+
+#if GFX_SIMD
+    __m128i Src = _mm_set1_epi32((int)Color);
+    for(; Count >= 4; Count -= 4, At += 4)
+    {
+        _mm_storeu_si128((__m128i*)At, Src);
+    }
+#endif
+
+    for(; Count > 0; Count--, At++)
+    {
+        *At = Color;
+    }
+}
+
+static void gfxSoftSpan(u32* Row, i32 X1, i32 X2, u32 Color)
+{
+    u32 Alpha = Color >> 24;
+    if(Alpha == 255)
+    {
+        gfxSoftFill(Row, X1, X2, Color);
+        return;
+    }
+
+    u32* At = Row + X1;
+    i32 Count = X2 - X1;
+
+#if GFX_SIMD
+    __m128i Src = _mm_set1_epi32((int)Color);
+    __m128i InvAlpha = _mm_set1_epi16((i16)(255 - Alpha));
+    for(; Count >= 4; Count -= 4, At += 4)
+    {
+        __m128i Dst = _mm_loadu_si128((__m128i*)At);
+        _mm_storeu_si128((__m128i*)At, gfxSoftBlend(Dst, Src, InvAlpha));
+    }
+#endif
+
+    for(; Count > 0; Count--, At++)
+    {
+        gfxSoftPixel(At, Color);
+    }
+}
+
+// NOTE: Pixel I is covered when its center I + 0.5 lies in [X1, X2)
+static i32 gfxSoftEdge(f32 X)
+{
+    return (i32) ceilf(X - 0.5f);
+}
+
+static void gfxSoftRect(gfx_prim* Prim, i32 CX1, i32 CY1, i32 CX2, i32 CY2)
+{
+    i32 X1 = Max(gfxSoftEdge(Prim->P[0]), CX1);
+    i32 Y1 = Max(gfxSoftEdge(Prim->P[1]), CY1);
+    i32 X2 = Min(gfxSoftEdge(Prim->P[2]), CX2);
+    i32 Y2 = Min(gfxSoftEdge(Prim->P[3]), CY2);
+    for(i32 Y = Y1; Y < Y2; Y++)
+    {
+        if(X1 < X2)
+        {
+            gfxSoftSpan(GfxSoft.Pixels + (usz)Y * GfxSoft.Cols, X1, X2, Prim->Color);
+        }
+    }
+}
+
+static void gfxSoftTriangle(gfx_prim* Prim, i32 CX1, i32 CY1, i32 CX2, i32 CY2)
+{
+    f32* P = Prim->P;
+    f32 MinY = Min(P[1], Min(P[3], P[5]));
+    f32 MaxY = Max(P[1], Max(P[3], P[5]));
+    i32 Y1 = Max(gfxSoftEdge(MinY), CY1);
+    i32 Y2 = Min(gfxSoftEdge(MaxY), CY2);
+    for(i32 Y = Y1; Y < Y2; Y++)
+    {
+        // NOTE: Triangle is convex, so a row through pixel centers crosses two edges
+        f32 C = Y + 0.5f;
+        f32 L = 1e30f;
+        f32 R = -1e30f;
+        for(u32 Edge = 0; Edge < 3; Edge++)
+        {
+            f32 AX = P[2*Edge+0], AY = P[2*Edge+1];
+            f32 BX = P[(2*Edge+2)%6], BY = P[(2*Edge+3)%6];
+            if((AY <= C && C < BY) || (BY <= C && C < AY))
+            {
+                f32 X = AX + (C - AY) * (BX - AX) / (BY - AY);
+                L = Min(L, X);
+                R = Max(R, X);
+            }
+        }
+
+        i32 X1 = Max(gfxSoftEdge(L), CX1);
+        i32 X2 = Min(gfxSoftEdge(R), CX2);
+        if(X1 < X2)
+        {
+            gfxSoftSpan(GfxSoft.Pixels + (usz)Y * GfxSoft.Cols, X1, X2, Prim->Color);
+        }
+    }
+}
+
+static void gfxSoftGlyph(gfx_prim* Prim, i32 CX1, i32 CY1, i32 CX2, i32 CY2)
+{
+    gfx_fnt* Fnt = &GfxFnt;
+    const u8* Bitmap = Fnt->Data + (usz)Prim->Slot * Fnt->Jump;
+
+    f32 QX = Prim->P[0];
+    f32 QY = Prim->P[1];
+    f32 SX = Fnt->Width / (Prim->P[2] - Prim->P[0]);
+    f32 SY = Fnt->Height / (Prim->P[3] - Prim->P[1]);
+
+    i32 X1 = Max(gfxSoftEdge(Prim->P[0]), CX1);
+    i32 Y1 = Max(gfxSoftEdge(Prim->P[1]), CY1);
+    i32 X2 = Min(gfxSoftEdge(Prim->P[2]), CX2);
+    i32 Y2 = Min(gfxSoftEdge(Prim->P[3]), CY2);
+    for(i32 Y = Y1; Y < Y2; Y++)
+    {
+        u32 Row = (u32) ((Y + 0.5f - QY) * SY);
+        const u8* Bits = Bitmap + Min(Row, Fnt->Height - 1) * Fnt->Skip;
+        u32* PixelRow = GfxSoft.Pixels + (usz)Y * GfxSoft.Cols;
+        for(i32 X = X1; X < X2; X++)
+        {
+            u32 Col = (u32) ((X + 0.5f - QX) * SX);
+            Col = Min(Col, Fnt->Width - 1);
+            if(Bits[Col >> 3] & (0x80 >> (Col & 7)))
+            {
+                gfxSoftPixel(PixelRow + X, Prim->Color);
+            }
+        }
+    }
+}
+
+static void gfxSoftImage(gfx_prim* Prim, i32 CX1, i32 CY1, i32 CX2, i32 CY2)
+{
+    gfx_img* Img = Prim->Img;
+
+    f32 QX = Prim->P[0];
+    f32 QY = Prim->P[1];
+    f32 SX = Img->Width / (Prim->P[2] - Prim->P[0]);
+    f32 SY = Img->Height / (Prim->P[3] - Prim->P[1]);
+
+    u32 Color = Prim->Color;
+    i32 X1 = Max(gfxSoftEdge(Prim->P[0]), CX1);
+    i32 Y1 = Max(gfxSoftEdge(Prim->P[1]), CY1);
+    i32 X2 = Min(gfxSoftEdge(Prim->P[2]), CX2);
+    i32 Y2 = Min(gfxSoftEdge(Prim->P[3]), CY2);
+    for(i32 Y = Y1; Y < Y2; Y++)
+    {
+        // NOTE: Bitmap rows are stored bottom-up
+        u32 Row = Min((u32) ((Y + 0.5f - QY) * SY), Img->Height - 1);
+        const u8* Texels = Img->Data + (Img->Height - 1 - Row) * Img->Jump;
+        u32* PixelRow = GfxSoft.Pixels + (usz)Y * GfxSoft.Cols;
+        for(i32 X = X1; X < X2; X++)
+        {
+            u32 Col = Min((u32) ((X + 0.5f - QX) * SX), Img->Width - 1);
+            const u8* Texel = Texels + 3 * Col;
+            u32 R = (Texel[2] * ((Color >> 0) & 0xFF) + 127) / 255;
+            u32 G = (Texel[1] * ((Color >> 8) & 0xFF) + 127) / 255;
+            u32 B = (Texel[0] * ((Color >> 16) & 0xFF) + 127) / 255;
+            gfxSoftPixel(PixelRow + X, R | (G << 8) | (B << 16) | (Color & 0xFF000000));
+        }
+    }
+}
+
+// NOTE: Copies the cached pixels of the grid, which are updated when the grid is submitted. Scrolling only
+// moves Top, so it is read at raster time too and must not change until the flush.
+static void gfxSoftGrid(gfx_prim* Prim, i32 CX1, i32 CY1, i32 CX2, i32 CY2)
+{
+    gfx_grid* Grid = Prim->Grid;
+    u32 CellRows = Grid->PixelRows / Grid->Rows;
+
+    i32 QX = gfxSoftEdge(Prim->P[0]);
+    i32 QY = gfxSoftEdge(Prim->P[1]);
+    i32 X1 = Max(QX, CX1);
+    i32 Y1 = Max(QY, CY1);
+    i32 X2 = Min(QX + (i32)Grid->PixelCols, CX2);
+    i32 Y2 = Min(QY + (i32)Grid->PixelRows, CY2);
+    for(i32 Y = Y1; Y < Y2; Y++)
+    {
+        u32 Row = (u32)(Y - QY);
+        u32 Stored = (Row / CellRows + Grid->Top) % Grid->Rows * CellRows + Row % CellRows;
+        const u32* Src = Grid->Pixels + (usz)Stored * Grid->PixelCols - QX;
+        u32* PixelRow = GfxSoft.Pixels + (usz)Y * GfxSoft.Cols;
+        for(i32 X = X1; X < X2; X++)
+        {
+            if(Src[X])
+            {
+                gfxSoftPixel(PixelRow + X, Src[X]);
+            }
+        }
+    }
+}
+
+static void gfxSoftClearRect(gfx_prim* Prim, i32 CX1, i32 CY1, i32 CX2, i32 CY2)
+{
+    for(i32 Y = CY1; Y < CY2; Y++)
+    {
+        gfxSoftFill(GfxSoft.Pixels + (usz)Y * GfxSoft.Cols, CX1, CX2, Prim->Color);
+    }
+}
+
+static void gfxSoftRaster(gfx_prim* Prim, i32 CX1, i32 CY1, i32 CX2, i32 CY2)
+{
+    CX1 = Max(CX1, Prim->Clip[0]);
+    CY1 = Max(CY1, Prim->Clip[1]);
+    CX2 = Min(CX2, Prim->Clip[2]);
+    CY2 = Min(CY2, Prim->Clip[3]);
+    if(CX1 >= CX2 || CY1 >= CY2)
+    {
+        return;
+    }
+
+    switch(Prim->Kind)
+    {
+        case GFX_PRIM_RECT:     gfxSoftRect(Prim, CX1, CY1, CX2, CY2); break;
+        case GFX_PRIM_TRIANGLE: gfxSoftTriangle(Prim, CX1, CY1, CX2, CY2); break;
+        case GFX_PRIM_GLYPH:    gfxSoftGlyph(Prim, CX1, CY1, CX2, CY2); break;
+        case GFX_PRIM_IMAGE:    gfxSoftImage(Prim, CX1, CY1, CX2, CY2); break;
+        case GFX_PRIM_CLEAR:    gfxSoftClearRect(Prim, CX1, CY1, CX2, CY2); break;
+        case GFX_PRIM_GRID:     gfxSoftGrid(Prim, CX1, CY1, CX2, CY2); break;
+    }
+}
+
+// NOTE: Range of tiles touched by the primitive, returns 0 when it is off screen or clipped away
+static b32 gfxSoftBounds(gfx_prim* Prim, u32* TX1, u32* TY1, u32* TX2, u32* TY2)
+{
+    gfx_soft* Soft = &GfxSoft;
+
+    f32 X1 = Prim->P[0], Y1 = Prim->P[1];
+    f32 X2 = Prim->P[2], Y2 = Prim->P[3];
+    if(Prim->Kind == GFX_PRIM_TRIANGLE)
+    {
+        X1 = Min(Prim->P[0], Min(Prim->P[2], Prim->P[4]));
+        Y1 = Min(Prim->P[1], Min(Prim->P[3], Prim->P[5]));
+        X2 = Max(Prim->P[0], Max(Prim->P[2], Prim->P[4]));
+        Y2 = Max(Prim->P[1], Max(Prim->P[3], Prim->P[5]));
+    }
+
+    i32 PX1 = Max(Max(gfxSoftEdge(X1), Prim->Clip[0]), 0);
+    i32 PY1 = Max(Max(gfxSoftEdge(Y1), Prim->Clip[1]), 0);
+    i32 PX2 = Min(Min(gfxSoftEdge(X2), Prim->Clip[2]), (i32)Soft->Cols);
+    i32 PY2 = Min(Min(gfxSoftEdge(Y2), Prim->Clip[3]), (i32)Soft->Rows);
+    if(PX1 >= PX2 || PY1 >= PY2)
+    {
+        return 0;
+    }
+
+    *TX1 = PX1 / GFX_SOFT_TILE;
+    *TY1 = PY1 / GFX_SOFT_TILE;
+    *TX2 = (PX2 - 1) / GFX_SOFT_TILE + 1;
+    *TY2 = (PY2 - 1) / GFX_SOFT_TILE + 1;
+    return 1;
+}
+
+static void gfxSoftBin(void)
+{
+    GFX_TRACE_BEGIN("gfxSoftBin");
+
+    gfx_soft* Soft = &GfxSoft;
+
+    u32* First = Soft->TileFirst;
+    memset(First, 0, (Soft->TileCount + 1) * sizeof(u32));
+
+    for(u32 Idx = 0; Idx < Soft->PrimCount; Idx++)
+    {
+        u32 TX1, TY1, TX2, TY2;
+        if(gfxSoftBounds(&Soft->Prims[Idx], &TX1, &TY1, &TX2, &TY2))
+        {
+            for(u32 TY = TY1; TY < TY2; TY++)
+            {
+                for(u32 TX = TX1; TX < TX2; TX++)
+                {
+                    First[TY * Soft->TileCols + TX]++;
+                }
+            }
+        }
+    }
+
+    u32 Total = 0;
+    for(u32 Tile = 0; Tile <= Soft->TileCount; Tile++)
+    {
+        u32 Count = First[Tile];
+        First[Tile] = Total;
+        Soft->TileNext[Tile] = Total;
+        Total += Count;
+    }
+
+    if(Total > Soft->BinCap)
+    {
+        if(Soft->Bins)
+        {
+            gfxVirtualFree(Soft->Bins);
+        }
+
+        Soft->BinCap = Max(Total, 2 * Soft->BinCap);
+        Assert(Soft->Bins = gfxVirtualAlloc(Soft->BinCap * sizeof(u32)));
+    }
+
+    for(u32 Idx = 0; Idx < Soft->PrimCount; Idx++)
+    {
+        u32 TX1, TY1, TX2, TY2;
+        if(gfxSoftBounds(&Soft->Prims[Idx], &TX1, &TY1, &TX2, &TY2))
+        {
+            for(u32 TY = TY1; TY < TY2; TY++)
+            {
+                for(u32 TX = TX1; TX < TX2; TX++)
+                {
+                    Soft->Bins[Soft->TileNext[TY * Soft->TileCols + TX]++] = Idx;
+                }
+            }
+        }
+    }
+
+    GFX_TRACE_END("gfxSoftBin");
+}
+
+// NOTE: Every thread takes whole tiles, so no pixel is written by two threads
+static void gfxSoftWork(void)
+{
+    GFX_TRACE_BEGIN("gfxSoftWork");
+
+    gfx_soft* Soft = &GfxSoft;
+    for(;;)
+    {
+        u32 Tile = gfxAtomicInc(&Soft->NextTile);
+        if(Tile >= Soft->TileCount)
+        {
+            break;
+        }
+
+        i32 CX1 = (Tile % Soft->TileCols) * GFX_SOFT_TILE;
+        i32 CY1 = (Tile / Soft->TileCols) * GFX_SOFT_TILE;
+        i32 CX2 = Min(CX1 + GFX_SOFT_TILE, (i32)Soft->Cols);
+        i32 CY2 = Min(CY1 + GFX_SOFT_TILE, (i32)Soft->Rows);
+        for(u32 Bin = Soft->TileFirst[Tile]; Bin < Soft->TileFirst[Tile+1]; Bin++)
+        {
+            gfxSoftRaster(&Soft->Prims[Soft->Bins[Bin]], CX1, CY1, CX2, CY2);
+        }
+    }
+
+    GFX_TRACE_END("gfxSoftWork");
+}
+
+static void gfxSoftWorker(void* Param)
+{
+    gfx_soft* Soft = &GfxSoft;
+    for(;;)
+    {
+        gfxSemWait(&Soft->Work);
+        gfxSoftWork();
+        gfxSemPost(&Soft->Done, 1);
+    }
+}
+
+// NOTE: Count is the total number of rasterizing threads, 0 picks one per CPU
+static void gfxSoftThreads(u32 Count)
+{
+    gfx_soft* Soft = &GfxSoft;
+
+    if(!Count)
+    {
+        Count = gfxCpuCount();
+    }
+
+    Count = Clamp(1, GFX_SOFT_THREADS, Count);
+    if(!Soft->WorkerCount && Count > 1)
+    {
+        Assert(gfxSemInit(&Soft->Work));
+        Assert(gfxSemInit(&Soft->Done));
+    }
+
+    // NOTE: Workers stay parked on the semaphore when the count goes down
+    while(Soft->WorkerCount + 1 < Count)
+    {
+        gfx_thread* Worker = &Soft->Workers[Soft->WorkerCount];
+        Worker->Proc = gfxSoftWorker;
+        Worker->Param = 0;
+        if(!gfxThreadStart(Worker))
+        {
+            gfxDebug("Failed to start rasterizer thread %u\n", Soft->WorkerCount);
+            break;
+        }
+
+        Soft->WorkerCount++;
+    }
+
+    Soft->ThreadCount = Min(Count, Soft->WorkerCount + 1);
+}
+
+static void gfxSoftFlush(void)
+{
+    gfx_soft* Soft = &GfxSoft;
+    if(Soft->PrimCount)
+    {
+        GfxStats.DrawCalls++;
+
+        gfxSoftBin();
+
+        u32 Helpers = Soft->ThreadCount ? Soft->ThreadCount - 1 : 0;
+        Soft->NextTile = 0;
+        if(Helpers)
+        {
+            gfxSemPost(&Soft->Work, Helpers);
+        }
+
+        gfxSoftWork();
+
+        for(u32 Idx = 0; Idx < Helpers; Idx++)
+        {
+            gfxSemWait(&Soft->Done);
+        }
+    }
+
+    Soft->PrimCount = 0;
+}
+
+// NOTE: Popup primitives are rasterized after everything submitted so far
+static void gfxSoftFlushPopup(void)
+{
+    gfx_soft* Soft = &GfxSoft;
+    for(u32 Idx = 0; Idx < Soft->PopupCount;)
+    {
+        u32 Count = Min(Soft->PopupCount - Idx, GFX_SOFT_PRIMS - Soft->PrimCount);
+        memcpy(Soft->Prims + Soft->PrimCount, Soft->Popup + Idx, Count * sizeof(gfx_prim));
+        Soft->PrimCount += Count;
+        Idx += Count;
+        gfxSoftFlush();
+    }
+
+    Soft->PopupCount = 0;
+    Soft->PopupCap = 0;
+    Soft->Popup = 0;
+}
+
+static gfx_prim* gfxSoftPush(u32 Kind)
+{
+    gfx_soft* Soft = &GfxSoft;
+    gfx_prim* Prim;
+    if(GfxLayer)
+    {
+        if(Soft->PopupCount == Soft->PopupCap)
+        {
+            gfx_prim* Popup = Soft->Popup;
+            Soft->PopupCap = Max(GFX_SOFT_POPUP, 2 * Soft->PopupCap);
+            Soft->Popup = gfxArenaPush(GfxFrameArena, Soft->PopupCap * sizeof(gfx_prim));
+            if(Popup)
+            {
+                memcpy(Soft->Popup, Popup, Soft->PopupCount * sizeof(gfx_prim));
+            }
+        }
+
+        Prim = &Soft->Popup[Soft->PopupCount++];
+    }
+    else
+    {
+        if(Soft->PrimCount == GFX_SOFT_PRIMS)
+        {
+            gfxSoftFlush();
+        }
+
+        Prim = &Soft->Prims[Soft->PrimCount++];
+    }
+
+    Prim->Kind = Kind;
+    GfxStats.Vertices += (Kind == GFX_PRIM_TRIANGLE) ? 3 : 4;
+    Prim->Color = GfxColor;
+    Prim->Slot = 0;
+    Prim->Img = 0;
+    memcpy(Prim->Clip, GfxState.Clip, sizeof(Prim->Clip));
+
+    return Prim;
+}
+
+static void gfxSoftClear(u32 Color)
+{
+    gfx_prim* Prim = gfxSoftPush(GFX_PRIM_CLEAR);
+    Prim->Color = Color;
+    Prim->P[0] = 0.0f;
+    Prim->P[1] = 0.0f;
+    Prim->P[2] = GfxCols;
+    Prim->P[3] = GfxRows;
+    Prim->Clip[0] = 0;
+    Prim->Clip[1] = 0;
+    Prim->Clip[2] = (i32)GfxCols;
+    Prim->Clip[3] = (i32)GfxRows;
+}
+
+//
+// CLIP AND TRANSFORM
+//
+
+// NOTE: Takes coordinates before the offset, returns 0 when nothing of the rectangle would be drawn
+static b32 gfxVisible(f32 X1, f32 Y1, f32 X2, f32 Y2)
+{
+    gfx_state* State = &GfxState;
+    X1 += State->Offset[0];
+    Y1 += State->Offset[1];
+    X2 += State->Offset[0];
+    Y2 += State->Offset[1];
+
+    if(State->Clip[0] < State->Clip[2] && State->Clip[1] < State->Clip[3] &&
+       X1 < State->Clip[2] && X2 > State->Clip[0] &&
+       Y1 < State->Clip[3] && Y2 > State->Clip[1])
+    {
+        return 1;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+static void gfxPush(void)
+{
+    Assert(GfxStackCount < GFX_STACK_DEPTH);
+    GfxStack[GfxStackCount++] = GfxState;
+}
+
+// NOTE: Restores clip and offset of the matching gfxPushClip or gfxPushTransform
+static void gfxPop(void)
+{
+    Assert(GfxStackCount > 0);
+    GfxState = GfxStack[--GfxStackCount];
+}
+
+// NOTE: Clip is intersected with the current one, so children never draw outside their parents
+static void gfxPushClip(f32 X1, f32 Y1, f32 X2, f32 Y2)
+{
+    gfxPush();
+
+    gfx_state* State = &GfxState;
+    i32 CX1 = (i32) ceilf(X1 + State->Offset[0] - 0.5f);
+    i32 CY1 = (i32) ceilf(Y1 + State->Offset[1] - 0.5f);
+    i32 CX2 = (i32) ceilf(X2 + State->Offset[0] - 0.5f);
+    i32 CY2 = (i32) ceilf(Y2 + State->Offset[1] - 0.5f);
+
+    State->Clip[0] = Max(State->Clip[0], CX1);
+    State->Clip[1] = Max(State->Clip[1], CY1);
+    State->Clip[2] = Max(State->Clip[0], Min(State->Clip[2], CX2));
+    State->Clip[3] = Max(State->Clip[1], Min(State->Clip[3], CY2));
+}
+
+static void gfxPushTransform(f32 X, f32 Y)
+{
+    gfxPush();
+
+    GfxState.Offset[0] += X;
+    GfxState.Offset[1] += Y;
+}
+
+// NOTE: Popups keep the offset but not the clip of their parent, they are drawn and hit above all
+// other widgets of the frame
+static void gfxBeginPopup(void)
+{
+    Assert(!GfxLayer);
+    gfxPush();
+
+    GfxLayer = 1;
+    GfxTarget = &GfxPopupDraw;
+    while(GfxTarget->Next)
+    {
+        GfxTarget = GfxTarget->Next;
+    }
+
+    GfxState.Clip[0] = 0;
+    GfxState.Clip[1] = 0;
+    GfxState.Clip[2] = (i32)GfxCols;
+    GfxState.Clip[3] = (i32)GfxRows;
+}
+
+static void gfxEndPopup(void)
+{
+    Assert(GfxLayer);
+    gfxPop();
+
+    GfxLayer = 0;
+    GfxTarget = &GfxDraw;
+}
+
+static void gfxFlush(void)
+{
+    GFX_TRACE_BEGIN("gfxFlush");
+
+    if(GfxBackend == GFX_BACKEND_SOFT)
+    {
+        if(GfxLayer)
+        {
+            gfxSoftFlushPopup();
+        }
+        else
+        {
+            gfxSoftFlush();
+        }
+
+        GFX_TRACE_END("gfxFlush");
+        return;
+    }
+
+#if GFX_GL
+    gfx_draw* Draw = GfxTarget;
+    if(Draw->CmdCount)
+    {
+        // NOTE: Pixel coordinates with origin in the top-left corner
+        m4f Proj;
+        gfxOrtho(Proj, 0.0f, GfxCols, GfxRows, 0.0f, -1.0f, 1.0f);
+
+        if(GfxBackend == GFX_BACKEND_CORE)
+        {
+            gfxCoreFlush(Draw, Proj);
+        }
+        else
+        {
+            gfxCompatFlush(Draw, Proj);
+        }
+    }
+
+    Draw->VtxCount = 0;
+    Draw->IdxCount = 0;
+    Draw->CmdCount = 0;
+#endif
+
+    GFX_TRACE_END("gfxFlush");
+}
+
+// NOTE: Popups are drawn after the frame, so a full popup list goes on in a new one instead of being flushed
+static gfx_draw* gfxDrawFull(void)
+{
+    if(GfxLayer)
+    {
+        gfx_draw* Draw = gfxArenaPush(GfxFrameArena, sizeof(gfx_draw));
+        memset(Draw, 0, sizeof(*Draw));
+        Draw->Vtx = gfxArenaPush(GfxFrameArena, GFX_DRAW_VTX * sizeof(gfx_vtx));
+        Draw->Idx = gfxArenaPush(GfxFrameArena, GFX_DRAW_IDX * sizeof(u16));
+        Draw->Cmd = gfxArenaPush(GfxFrameArena, GFX_DRAW_CMD * sizeof(gfx_cmd));
+        GfxTarget->Next = Draw;
+        GfxTarget = Draw;
+    }
+    else
+    {
+        gfxFlush();
+    }
+
+    return GfxTarget;
+}
+
+static u32 gfxReserve(u32 Texture, u32 VtxCount, u32 IdxCount)
+{
+    gfx_draw* Draw = GfxTarget;
+    if(Draw->VtxCount + VtxCount > GFX_DRAW_VTX ||
+       Draw->IdxCount + IdxCount > GFX_DRAW_IDX)
+    {
+        Draw = gfxDrawFull();
+    }
+
+    gfx_cmd* Cmd = Draw->CmdCount ? &Draw->Cmd[Draw->CmdCount-1] : 0;
+    if(!Cmd || Cmd->Texture != Texture || memcmp(Cmd->Clip, GfxState.Clip, sizeof(Cmd->Clip)) != 0)
+    {
+        if(Draw->CmdCount == GFX_DRAW_CMD)
+        {
+            Draw = gfxDrawFull();
+        }
+
+        Cmd = &Draw->Cmd[Draw->CmdCount++];
+        Cmd->Texture = Texture;
+        Cmd->First = Draw->IdxCount;
+        Cmd->Count = 0;
+        memcpy(Cmd->Clip, GfxState.Clip, sizeof(Cmd->Clip));
+    }
+
+    Cmd->Count += IdxCount;
+    GfxStats.Vertices += VtxCount;
+
+    return Draw->VtxCount;
+}
+
+static void gfxVertex(f32 X, f32 Y, f32 U, f32 V)
+{
+    gfx_vtx* Vtx = &GfxTarget->Vtx[GfxTarget->VtxCount++];
+    Vtx->X = X;
+    Vtx->Y = Y;
+    Vtx->U = U;
+    Vtx->V = V;
+    Vtx->Color = GfxColor;
+}
+
+static void gfxIndex(u32 Base, u32 A, u32 B, u32 C)
+{
+    u16* Idx = &GfxTarget->Idx[GfxTarget->IdxCount];
+    Idx[0] = (u16)(Base + A);
+    Idx[1] = (u16)(Base + B);
+    Idx[2] = (u16)(Base + C);
+    GfxTarget->IdxCount += 3;
+}
+
+static void gfxQuad(u32 Texture, f32 X1, f32 Y1, f32 X2, f32 Y2, f32 U1, f32 V1, f32 U2, f32 V2)
+{
+    u32 Base = gfxReserve(Texture, 4, 6);
+    gfxVertex(X1, Y1, U1, V1);
+    gfxVertex(X2, Y1, U2, V1);
+    gfxVertex(X1, Y2, U1, V2);
+    gfxVertex(X2, Y2, U2, V2);
+    gfxIndex(Base, 0, 1, 2);
+    gfxIndex(Base, 3, 1, 2);
+}
+
+static void gfxTriangle(f32 X1, f32 Y1, f32 X2, f32 Y2, f32 X3, f32 Y3)
+{
+    if(!gfxVisible(Min(X1, Min(X2, X3)), Min(Y1, Min(Y2, Y3)),
+                   Max(X1, Max(X2, X3)), Max(Y1, Max(Y2, Y3))))
+    {
+        return;
+    }
+
+    X1 += GfxState.Offset[0]; Y1 += GfxState.Offset[1];
+    X2 += GfxState.Offset[0]; Y2 += GfxState.Offset[1];
+    X3 += GfxState.Offset[0]; Y3 += GfxState.Offset[1];
+
+    if(GfxBackend == GFX_BACKEND_SOFT)
+    {
+        gfx_prim* Prim = gfxSoftPush(GFX_PRIM_TRIANGLE);
+        Prim->P[0] = X1; Prim->P[1] = Y1;
+        Prim->P[2] = X2; Prim->P[3] = Y2;
+        Prim->P[4] = X3; Prim->P[5] = Y3;
+        return;
+    }
+
+    f32 U = GfxFnt.White[0];
+    f32 V = GfxFnt.White[1];
+    u32 Base = gfxReserve(GfxFnt.Texture, 3, 3);
+    gfxVertex(X1, Y1, U, V);
+    gfxVertex(X2, Y2, U, V);
+    gfxVertex(X3, Y3, U, V);
+    gfxIndex(Base, 0, 1, 2);
+}
+
+static u32 gfxPackColor(f32 R, f32 G, f32 B, f32 A)
+{
+    u32 Result = ((u32)(Clamp(0.0f, 1.0f, R) * 255.0f + 0.5f) << 0) |
+                 ((u32)(Clamp(0.0f, 1.0f, G) * 255.0f + 0.5f) << 8) |
+                 ((u32)(Clamp(0.0f, 1.0f, B) * 255.0f + 0.5f) << 16) |
+                 ((u32)(Clamp(0.0f, 1.0f, A) * 255.0f + 0.5f) << 24);
+    return Result;
+}
+
+static void gfxColor4f(f32 R, f32 G, f32 B, f32 A)
+{
+    GfxColor = gfxPackColor(R, G, B, A);
+}
+
+static void gfxColor3f(f32 R, f32 G, f32 B)
+{
+    GfxColor = gfxPackColor(R, G, B, 1.0f);
+}
+
+static void gfxText(const char* Text, usz Size)
+{
+    GFX_TRACE_BEGIN("gfxText");
+
+    f32 X1 = GfxPos[0] + GfxState.Offset[0];
+    f32 Y1 = GfxPos[1] + GfxState.Offset[1];
+
+    f32 X = X1;
+    f32 Y2 = Y1 + GfxFnt.Rows;
+
+    // NOTE: Lines above or below the clip skip decoding altogether
+    i32* Clip = GfxState.Clip;
+    if(Y1 >= Clip[3] || Y2 <= Clip[1])
+    {
+        Size = 0;
+    }
+
+    for(usz Idx = 0; Idx < Size && X < Clip[2];)
+    {
+        u32 Codepoint = gfxUtf8Next(Text, Size, &Idx);
+        if(X + GfxFnt.Cols <= Clip[0])
+        {
+            X += GfxFnt.Cols;
+            continue;
+        }
+
+        u32 Slot = gfxGlyph(&GfxFnt, Codepoint);
+        GfxStats.Glyphs++;
+
+        if(GfxBackend == GFX_BACKEND_SOFT)
+        {
+            gfx_prim* Prim = gfxSoftPush(GFX_PRIM_GLYPH);
+            Prim->Slot = Slot;
+            Prim->P[0] = X;
+            Prim->P[1] = Y1;
+            Prim->P[2] = X+GfxFnt.Cols;
+            Prim->P[3] = Y2;
+        }
+        else
+        {
+            f32* Uv = GfxFnt.Uvs + 4 * Slot;
+            gfxQuad(GfxFnt.Texture, X, Y1, X+GfxFnt.Cols, Y2, Uv[0], Uv[1], Uv[2], Uv[3]);
+        }
+
+        X += GfxFnt.Cols;
+    }
+
+#if 0
+    gfxColor4f(1.0f, 0.0f, 0.0f, 1.0f);
+    gfxRectLines(X1, Y1, X, Y2);
+#endif
+
+    GfxPos[1] += GfxFnt.Rows + GfxSep;
+
+    GFX_TRACE_END("gfxText");
+}
+
+static void gfxString(const char* String)
+{
+    usz Length = strlen(String);
+    gfxText(String, Length);
+}
+
+static void gfxImage(gfx_img* Img)
+{
+    f32 X = GfxPos[0];
+    f32 Y = GfxPos[1];
+
+    gfxColor3f(1.0f, 1.0f, 1.0f);
+
+    if(!gfxVisible(X, Y, X+Img->Cols, Y+Img->Rows))
+    {
+        GfxPos[1] += Img->Rows + GfxSep;
+        return;
+    }
+
+    X += GfxState.Offset[0];
+    Y += GfxState.Offset[1];
+
+    if(GfxBackend == GFX_BACKEND_SOFT)
+    {
+        gfx_prim* Prim = gfxSoftPush(GFX_PRIM_IMAGE);
+        Prim->Img = Img;
+        Prim->P[0] = X;
+        Prim->P[1] = Y;
+        Prim->P[2] = X+Img->Cols;
+        Prim->P[3] = Y+Img->Rows;
+    }
+    else
+    {
+        gfxQuad(Img->Texture, X, Y, X+Img->Cols, Y+Img->Rows, 0.0f, 1.0f, 1.0f, 0.0f);
+    }
+
+    GfxPos[1] += Img->Rows + GfxSep;
+}
+
+static gfx_cell* gfxGridRow(gfx_grid* Grid, u32 Row)
+{
+    return Grid->Cells + (usz)((Grid->Top + Row) % Grid->Rows) * Grid->Cols;
+}
+
+// NOTE: Marks drawn cells [Col1, Col2) x [Row1, Row2) as changed, the union with earlier changes is kept
+static void gfxGridDirty(gfx_grid* Grid, u32 Col1, u32 Row1, u32 Col2, u32 Row2)
+{
+    Col2 = Min(Col2, Grid->Cols);
+    Row2 = Min(Row2, Grid->Rows);
+    if(Col1 >= Col2 || Row1 >= Row2)
+    {
+        return;
+    }
+
+    // NOTE: Rows wrapping around the end of the ring mark all of them
+    u32 Stored1 = (Grid->Top + Row1) % Grid->Rows;
+    u32 Stored2 = Stored1 + (Row2 - Row1);
+    if(Stored2 > Grid->Rows)
+    {
+        Stored1 = 0;
+        Stored2 = Grid->Rows;
+    }
+
+    u32* Dirty = Grid->Dirty;
+    if(Dirty[0] >= Dirty[2])
+    {
+        Dirty[0] = Col1;
+        Dirty[1] = Stored1;
+        Dirty[2] = Col2;
+        Dirty[3] = Stored2;
+    }
+    else
+    {
+        Dirty[0] = Min(Dirty[0], Col1);
+        Dirty[1] = Min(Dirty[1], Stored1);
+        Dirty[2] = Max(Dirty[2], Col2);
+        Dirty[3] = Max(Dirty[3], Stored2);
+    }
+}
+
+// NOTE: Moves the rows up by Count, or down when it is negative, and blanks the rows that come in. Only the
+// ring start moves, the other rows stay where they are in the cells and in the copies of them.
+static void gfxGridScroll(gfx_grid* Grid, i32 Count)
+{
+    u32 Rows = Grid->Rows;
+    u32 Blank = Min((u32)((Count < 0) ? -Count : Count), Rows);
+    if(!Blank)
+    {
+        return;
+    }
+
+    u32 First;
+    if(Count > 0)
+    {
+        Grid->Top = (Grid->Top + Blank) % Rows;
+        First = Rows - Blank;
+    }
+    else
+    {
+        Grid->Top = (Grid->Top + Rows - Blank) % Rows;
+        First = 0;
+    }
+
+    for(u32 Row = First; Row < First + Blank; Row++)
+    {
+        gfx_cell* Cells = gfxGridRow(Grid, Row);
+        for(u32 Col = 0; Col < Grid->Cols; Col++)
+        {
+            Cells[Col].Code = ' ';
+            Cells[Col].Fg = 0;
+            Cells[Col].Bg = 0;
+        }
+    }
+
+    gfxGridDirty(Grid, 0, First, Grid->Cols, First + Blank);
+}
+
+// NOTE: Writes UTF-8 text into the cells of a row, clipped to the grid, returns the column after it
+static u32 gfxGridText(gfx_grid* Grid, u32 Col, u32 Row, const char* Text, usz Size, u32 Fg, u32 Bg)
+{
+    u32 Col1 = Col;
+    if(Row < Grid->Rows)
+    {
+        gfx_cell* Cells = gfxGridRow(Grid, Row);
+        for(usz Idx = 0; Idx < Size && Col < Grid->Cols; Col++)
+        {
+            gfx_cell* Cell = &Cells[Col];
+            u32 Code = gfxUtf8Next(Text, Size, &Idx);
+            if(Cell->Code != Code || Cell->Fg != Fg || Cell->Bg != Bg)
+            {
+                Cell->Code = Code;
+                Cell->Fg = Fg;
+                Cell->Bg = Bg;
+                gfxGridDirty(Grid, Col, Row, Col + 1, Row + 1);
+            }
+        }
+    }
+
+    return Col;
+}
+
+static void gfxGridFree(gfx_grid* Grid)
+{
+#if GFX_GL
+    if(Grid->Texture)
+    {
+        glDeleteTextures(1, &Grid->Texture);
+    }
+#endif
+
+    if(Grid->Pixels)
+    {
+        gfxVirtualFree(Grid->Pixels);
+    }
+
+    Grid->Texture = 0;
+    Grid->Pixels = 0;
+}
+
+// NOTE: Rasterizes stored cells [Col1, Col2) x [Row1, Row2) into the pixel copy of the software backend
+static void gfxGridRaster(gfx_grid* Grid, u32 Col1, u32 Row1, u32 Col2, u32 Row2)
+{
+    gfx_fnt* Fnt = &GfxFnt;
+    f32 SX = (f32)Fnt->Width / Fnt->Cols;
+    f32 SY = (f32)Fnt->Height / Fnt->Rows;
+
+    for(u32 Row = Row1; Row < Row2; Row++)
+    {
+        gfx_cell* Cells = Grid->Cells + (usz)Row * Grid->Cols;
+        for(u32 Y = 0; Y < Fnt->Rows; Y++)
+        {
+            u32 GlyphRow = Min((u32)((Y + 0.5f) * SY), Fnt->Height - 1);
+            u32* PixelRow = Grid->Pixels + (usz)(Row * Fnt->Rows + Y) * Grid->PixelCols;
+            for(u32 Col = Col1; Col < Col2; Col++)
+            {
+                gfx_cell* Cell = &Cells[Col];
+                const u8* Bits = Fnt->Data + (usz)gfxGlyph(Fnt, Cell->Code) * Fnt->Jump + GlyphRow * Fnt->Skip;
+                u32* At = PixelRow + Col * Fnt->Cols;
+                for(u32 X = 0; X < Fnt->Cols; X++)
+                {
+                    At[X] = Cell->Bg;
+
+                    u32 Bit = Min((u32)((X + 0.5f) * SX), Fnt->Width - 1);
+                    if(Bits[Bit >> 3] & (0x80 >> (Bit & 7)))
+                    {
+                        gfxSoftPixel(At + X, Cell->Fg);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// NOTE: Draws the grid at the layout position, in one draw call on the core backend. The compatibility
+// backend falls back to quads of the visible cells.
+static void gfxGrid(gfx_grid* Grid)
+{
+    GFX_TRACE_BEGIN("gfxGrid");
+
+    f32 X = GfxPos[0];
+    f32 Y = GfxPos[1];
+    f32 Cols = (f32)GfxFnt.Cols;
+    f32 Rows = (f32)GfxFnt.Rows;
+
+    GfxPos[1] += Grid->Rows * Rows + GfxSep;
+
+    if(!Grid->Cols || !Grid->Rows || !gfxVisible(X, Y, X + Grid->Cols * Cols, Y + Grid->Rows * Rows))
+    {
+        GFX_TRACE_END("gfxGrid");
+        return;
+    }
+
+    X += GfxState.Offset[0];
+    Y += GfxState.Offset[1];
+
+    u32* Dirty = Grid->Dirty;
+    if(GfxBackend == GFX_BACKEND_SOFT)
+    {
+        u32 PixelCols = Grid->Cols * GfxFnt.Cols;
+        u32 PixelRows = Grid->Rows * GfxFnt.Rows;
+        if(!Grid->Pixels || Grid->PixelCols != PixelCols || Grid->PixelRows != PixelRows)
+        {
+            if(Grid->Pixels)
+            {
+                gfxVirtualFree(Grid->Pixels);
+            }
+
+            Assert(Grid->Pixels = gfxVirtualAlloc((usz)PixelCols * PixelRows * sizeof(u32)));
+            Grid->PixelCols = PixelCols;
+            Grid->PixelRows = PixelRows;
+            gfxGridRaster(Grid, 0, 0, Grid->Cols, Grid->Rows);
+        }
+        else if(Dirty[0] < Dirty[2])
+        {
+            gfxGridRaster(Grid, Dirty[0], Dirty[1], Dirty[2], Dirty[3]);
+        }
+
+        Dirty[0] = Dirty[2] = 0;
+
+        gfx_prim* Prim = gfxSoftPush(GFX_PRIM_GRID);
+        Prim->Grid = Grid;
+        Prim->P[0] = X;
+        Prim->P[1] = Y;
+        Prim->P[2] = X + Grid->Cols * Cols;
+        Prim->P[3] = Y + Grid->Rows * Rows;
+        GfxStats.Glyphs += Grid->Cols * Grid->Rows;
+    }
+#if GFX_GL
+    else if(GfxBackend == GFX_BACKEND_CORE && !GfxLayer)
+    {
+        // NOTE: Widgets submitted so far go first, to keep the order. Popups are drawn after the frame, so
+        // grids inside them take the quads below.
+        gfxFlush();
+
+        m4f Proj;
+        gfxOrtho(Proj, 0.0f, GfxCols, GfxRows, 0.0f, -1.0f, 1.0f);
+        gfxCoreGrid(Grid, X, Y, Proj);
+        GfxStats.Glyphs += Grid->Cols * Grid->Rows;
+        Dirty[0] = Dirty[2] = 0;
+    }
+#endif
+    else
+    {
+        // NOTE: Only the cells inside the clip, neighbors with the same background share a quad
+        i32* Clip = GfxState.Clip;
+        u32 Col1 = (u32)Clamp(0.0f, (f32)Grid->Cols, floorf((Clip[0] - X) / Cols));
+        u32 Col2 = (u32)Clamp(0.0f, (f32)Grid->Cols, ceilf((Clip[2] - X) / Cols));
+        u32 Row1 = (u32)Clamp(0.0f, (f32)Grid->Rows, floorf((Clip[1] - Y) / Rows));
+        u32 Row2 = (u32)Clamp(0.0f, (f32)Grid->Rows, ceilf((Clip[3] - Y) / Rows));
+        f32 U = GfxFnt.White[0];
+        f32 V = GfxFnt.White[1];
+        u32 Color = GfxColor;
+        for(u32 Row = Row1; Row < Row2; Row++)
+        {
+            gfx_cell* Cells = gfxGridRow(Grid, Row);
+            f32 Y1 = Y + Row * Rows;
+            for(u32 Col = Col1; Col < Col2;)
+            {
+                u32 End = Col + 1;
+                while(End < Col2 && Cells[End].Bg == Cells[Col].Bg)
+                {
+                    End++;
+                }
+
+                if(Cells[Col].Bg)
+                {
+                    GfxColor = Cells[Col].Bg;
+                    gfxQuad(GfxFnt.Texture, X + Col * Cols, Y1, X + End * Cols, Y1 + Rows, U, V, U, V);
+                }
+
+                Col = End;
+            }
+
+            for(u32 Col = Col1; Col < Col2; Col++)
+            {
+                u32 Slot = gfxGlyph(&GfxFnt, Cells[Col].Code);
+                if(Cells[Col].Code != ' ')
+                {
+                    f32* Uv = GfxFnt.Uvs + 4 * Slot;
+                    GfxColor = Cells[Col].Fg;
+                    gfxQuad(GfxFnt.Texture, X + Col * Cols, Y1, X + (Col + 1) * Cols, Y1 + Rows, Uv[0], Uv[1], Uv[2], Uv[3]);
+                    GfxStats.Glyphs++;
+                }
+            }
+        }
+
+        GfxColor = Color;
+    }
+
+    GFX_TRACE_END("gfxGrid");
+}
+
+void gfxPolygon(f32 CX, f32 CY, f32 R, u32 N)
+{
+    if(N < 3 || !gfxVisible(CX - R, CY - R, CX + R, CY + R))
+    {
+        return;
+    }
+
+    if(GfxBackend == GFX_BACKEND_SOFT)
+    {
+        f32 X0 = CX + R, Y0 = CY;
+        f32 XP = X0, YP = Y0;
+        for(u32 Idx = 1; Idx < N; Idx++)
+        {
+            f32 Theta = 2.0f * PI_F32 * Idx / N;
+            f32 X = R * cosf(Theta) + CX;
+            f32 Y = R * sinf(Theta) + CY;
+            if(Idx >= 2)
+            {
+                gfxTriangle(X0, Y0, XP, YP, X, Y);
+            }
+            XP = X;
+            YP = Y;
+        }
+        return;
+    }
+
+    // NOTE: The fan goes out in batches that fit one draw, each repeats the first vertex and the last
+    // vertex of the previous batch
+    f32 U = GfxFnt.White[0];
+    f32 V = GfxFnt.White[1];
+    f32 X0 = R + CX + GfxState.Offset[0];
+    f32 Y0 = CY + GfxState.Offset[1];
+    for(u32 First = 1; First + 1 < N;)
+    {
+        u32 Count = Min(GFX_DRAW_VTX - 1, N - First);
+        u32 Base = gfxReserve(GfxFnt.Texture, Count + 1, 3 * (Count - 1));
+
+        gfxVertex(X0, Y0, U, V);
+        for(u32 Idx = First; Idx < First + Count; Idx++)
+        {
+            f32 Theta = 2.0f * PI_F32 * Idx / N;
+            f32 X = R * cosf(Theta);
+            f32 Y = R * sinf(Theta);
+            gfxVertex(X + CX + GfxState.Offset[0], Y + CY + GfxState.Offset[1], U, V);
+        }
+
+        for(u32 Idx = 2; Idx <= Count; Idx++)
+        {
+            gfxIndex(Base, 0, Idx - 1, Idx);
+        }
+
+        First += Count - 1;
+    }
+}
+
+static void gfxColorRGB8(u8 R, u8 G, u8 B)
+{
+    GfxColor = R | (G << 8) | (B << 16) | 0xFF000000;
+}
+
+static b32 gfxPointInRect(v2f Pt, v2f TL, v2f BR)
+{
+    if(Pt[0] >= TL[0] && Pt[0] <= BR[0] &&
+       Pt[1] >= TL[1] && Pt[1] <= BR[1])
+    {
+        return 1;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+static void gfxRect(f32 X1, f32 Y1, f32 X2, f32 Y2)
+{
+    if(!gfxVisible(Min(X1, X2), Min(Y1, Y2), Max(X1, X2), Max(Y1, Y2)))
+    {
+        return;
+    }
+
+    X1 += GfxState.Offset[0];
+    Y1 += GfxState.Offset[1];
+    X2 += GfxState.Offset[0];
+    Y2 += GfxState.Offset[1];
+
+    if(GfxBackend == GFX_BACKEND_SOFT)
+    {
+        gfx_prim* Prim = gfxSoftPush(GFX_PRIM_RECT);
+        Prim->P[0] = Min(X1, X2);
+        Prim->P[1] = Min(Y1, Y2);
+        Prim->P[2] = Max(X1, X2);
+        Prim->P[3] = Max(Y1, Y2);
+        return;
+    }
+
+    gfxQuad(GfxFnt.Texture, X1, Y1, X2, Y2, GfxFnt.White[0], GfxFnt.White[1], GfxFnt.White[0], GfxFnt.White[1]);
+}
+
+static void gfxRectLines(f32 X1, f32 Y1, f32 X2, f32 Y2)
+{
+    gfxRect(X1, Y1, X2, Y1 + 1.0f);
+    gfxRect(X1, Y2 - 1.0f, X2, Y2);
+    gfxRect(X1, Y1 + 1.0f, X1 + 1.0f, Y2 - 1.0f);
+    gfxRect(X2 - 1.0f, Y1 + 1.0f, X2, Y2 - 1.0f);
+}
+
+//
+// WIDGET STATE
+//
+
+static gfx_id GfxIdStack[GFX_STACK_DEPTH];
+static u32 GfxIdCount;
+
+// NOTE: FNV-1a finished with the murmur3 mixer, so the low bits are good enough to index a table
+static u32 gfxHash(const void* Data, usz Size, u32 Seed)
+{
+    const u8* Bytes = Data;
+    u32 Hash = 2166136261u ^ Seed;
+    for(usz Idx = 0; Idx < Size; Idx++)
+    {
+        Hash ^= Bytes[Idx];
+        Hash *= 16777619u;
+    }
+
+    Hash ^= Hash >> 16;
+    Hash *= 0x85EBCA6Bu;
+    Hash ^= Hash >> 13;
+    Hash *= 0xC2B2AE35u;
+    Hash ^= Hash >> 16;
+    return Hash;
+}
+
+static gfx_id gfxIdFrom(const void* Data, usz Size)
+{
+    gfx_id Seed = GfxIdCount ? GfxIdStack[GfxIdCount-1] : 0;
+    gfx_id Id = gfxHash(Data, Size, Seed);
+    return Id ? Id : 1;
+}
+
+static gfx_id gfxId(const char* Label)
+{
+    return gfxIdFrom(Label, strlen(Label));
+}
+
+static gfx_id gfxIdPtr(const void* Ptr)
+{
+    return gfxIdFrom(&Ptr, sizeof(Ptr));
+}
+
+// NOTE: Widgets inside the scope get different IDs even when their labels are the same as outside of it
+static void gfxPushId(const char* Label)
+{
+    gfx_id Id = gfxId(Label);
+    Assert(GfxIdCount < GFX_STACK_DEPTH);
+    GfxIdStack[GfxIdCount++] = Id;
+}
+
+static void gfxPushIdInt(i32 Value)
+{
+    gfx_id Id = gfxIdFrom(&Value, sizeof(Value));
+    Assert(GfxIdCount < GFX_STACK_DEPTH);
+    GfxIdStack[GfxIdCount++] = Id;
+}
+
+static void gfxPopId(void)
+{
+    Assert(GfxIdCount > 0);
+    GfxIdCount--;
+}
+
+#define GFX_WIDGET_TTL 64 // Frames the state of a widget survives without being looked up
+
+typedef struct
+{
+    gfx_id Id;
+    u32 Frame; // Frame of the last lookup
+    b32 Open;
+} gfx_widget;
+
+// NOTE: Open addressing with linear probing, kept at most half full
+typedef struct
+{
+    u32 Cap; // Power of two
+    u32 Count;
+    u32 Collect; // Frame of the next collection
+    gfx_widget* Slots;
+} gfx_widgets;
+
+static gfx_widgets GfxWidgets;
+
+static gfx_widget* gfxWidgetSlot(gfx_widgets* Table, gfx_id Id)
+{
+    u32 Mask = Table->Cap - 1;
+    u32 Idx = Id & Mask;
+    while(Table->Slots[Idx].Id && Table->Slots[Idx].Id != Id)
+    {
+        Idx = (Idx + 1) & Mask;
+    }
+    return &Table->Slots[Idx];
+}
+
+// NOTE: Moves the states into a new table, dropping the ones not looked up for GFX_WIDGET_TTL frames
+static void gfxWidgetRehash(gfx_widgets* Table, u32 Cap)
+{
+    gfx_widget* Slots = Table->Slots;
+    u32 OldCap = Table->Cap;
+
+    Assert(Table->Slots = gfxVirtualAlloc(Cap * sizeof(gfx_widget)));
+    memset(Table->Slots, 0, Cap * sizeof(gfx_widget));
+    Table->Cap = Cap;
+    Table->Count = 0;
+
+    for(u32 Idx = 0; Idx < OldCap; Idx++)
+    {
+        gfx_widget* Widget = &Slots[Idx];
+        if(Widget->Id && (u32)GfxFrame - Widget->Frame < GFX_WIDGET_TTL)
+        {
+            *gfxWidgetSlot(Table, Widget->Id) = *Widget;
+            Table->Count++;
+        }
+    }
+
+    if(Slots)
+    {
+        gfxVirtualFree(Slots);
+    }
+}
+
+// NOTE: State of the widget, zeroed when it is seen for the first time
+static gfx_widget* gfxWidget(gfx_id Id)
+{
+    gfx_widgets* Table = &GfxWidgets;
+    if(!Table->Slots)
+    {
+        gfxWidgetRehash(Table, 256);
+    }
+
+    if((u32)GfxFrame >= Table->Collect)
+    {
+        // NOTE: Shrinks gradually once most of the widgets are gone
+        b32 Shrink = Table->Cap > 256 && 8 * Table->Count < Table->Cap;
+        gfxWidgetRehash(Table, Shrink ? Table->Cap / 2 : Table->Cap);
+        Table->Collect = (u32)GfxFrame + GFX_WIDGET_TTL;
+    }
+
+    gfx_widget* Widget = gfxWidgetSlot(Table, Id);
+    if(!Widget->Id)
+    {
+        if(2 * (Table->Count + 1) > Table->Cap)
+        {
+            gfxWidgetRehash(Table, 2 * Table->Cap);
+            Widget = gfxWidgetSlot(Table, Id);
+        }
+
+        Widget->Id = Id;
+        Table->Count++;
+    }
+
+    Widget->Frame = (u32)GfxFrame;
+    return Widget;
+}
+
+//
+// HIT TESTING
+//
+
+typedef struct
+{
+    gfx_id Id;
+    u32 Layer; // The topmost widget has the largest layer, then the largest order
+    u32 Order; // Submission order within the frame
+    f32 Rect[4]; // Screen X1 Y1 X2 Y2, clipped
+} gfx_hit;
+
+// NOTE: Widget rectangles of the frame being built, and the ones of the previous frame that answer which
+// widget is under a point. The cursor is the only point asked every frame, one scan over the rectangles
+// is cheaper than building any index for it. Everything lives in the frame arenas.
+typedef struct
+{
+    u32 Count;
+    u32 Cap;
+    gfx_hit* Items;
+    u32 PrevCount;
+    gfx_hit* Prev;
+    b32 Resolved; // GfxHover is set for this frame
+} gfx_hits;
+
+static gfx_hits GfxHits;
+static gfx_id GfxHover; // Topmost widget under the cursor, in the layout of the previous frame
+
+static b32 gfxHitAbove(gfx_hit* Hit, gfx_hit* Top)
+{
+    return !Top || Hit->Layer > Top->Layer || (Hit->Layer == Top->Layer && Hit->Order >= Top->Order);
+}
+
+static b32 gfxHitInside(gfx_hit* Hit, f32 X, f32 Y)
+{
+    return X >= Hit->Rect[0] && X <= Hit->Rect[2] && Y >= Hit->Rect[1] && Y <= Hit->Rect[3];
+}
+
+// NOTE: Topmost widget at the point of the screen, in the layout of the previous frame
+static gfx_id gfxHitTest(f32 X, f32 Y)
+{
+    gfx_hits* Hits = &GfxHits;
+    gfx_hit* Top = 0;
+    for(u32 Idx = 0; Idx < Hits->PrevCount; Idx++)
+    {
+        gfx_hit* Hit = &Hits->Prev[Idx];
+        if(gfxHitInside(Hit, X, Y) && gfxHitAbove(Hit, Top))
+        {
+            Top = Hit;
+        }
+    }
+
+    return Top ? Top->Id : 0;
+}
+
+// NOTE: Done once per frame, before the first widget looks at GfxHover
+static void gfxHitResolve(void)
+{
+    gfx_hits* Hits = &GfxHits;
+    if(!Hits->Resolved)
+    {
+        GfxHover = gfxHitTest(GfxCur[0], GfxCur[1]);
+        Hits->Resolved = 1;
+    }
+}
+
+static void gfxHitRecord(gfx_id Id, v2f TL, v2f BR)
+{
+    gfxHitResolve();
+
+    gfx_state* State = &GfxState;
+    f32 X1 = Max(TL[0] + State->Offset[0], (f32)State->Clip[0]);
+    f32 Y1 = Max(TL[1] + State->Offset[1], (f32)State->Clip[1]);
+    f32 X2 = Min(BR[0] + State->Offset[0], (f32)State->Clip[2]);
+    f32 Y2 = Min(BR[1] + State->Offset[1], (f32)State->Clip[3]);
+    if(X1 > X2 || Y1 > Y2)
+    {
+        return;
+    }
+
+    // NOTE: Sized after the previous frame, so it rarely has to grow
+    gfx_hits* Hits = &GfxHits;
+    if(Hits->Count == Hits->Cap)
+    {
+        gfx_hit* Items = Hits->Items;
+        Hits->Cap = Max(Max(256, 2 * Hits->Cap), Hits->PrevCount);
+        Hits->Items = gfxArenaPush(GfxFrameArena, Hits->Cap * sizeof(gfx_hit));
+        if(Items)
+        {
+            memcpy(Hits->Items, Items, Hits->Count * sizeof(gfx_hit));
+        }
+    }
+
+    gfx_hit* Hit = &Hits->Items[Hits->Count];
+    Hit->Id = Id;
+    Hit->Layer = GfxLayer;
+    Hit->Order = Hits->Count;
+    Hit->Rect[0] = X1;
+    Hit->Rect[1] = Y1;
+    Hit->Rect[2] = X2;
+    Hit->Rect[3] = Y2;
+    Hits->Count++;
+}
+
+// NOTE: Rectangles of this frame become the index of the next one, its frame arena is kept until then
+static void gfxHitSwap(void)
+{
+    gfx_hits* Hits = &GfxHits;
+    Hits->Prev = Hits->Items;
+    Hits->PrevCount = Hits->Count;
+    Hits->Items = 0;
+    Hits->Cap = 0;
+    Hits->Count = 0;
+    Hits->Resolved = 0;
+}
+
+typedef enum
+{
+    GFX_ITEM_IDLE,
+    GFX_ITEM_HOVER,
+    GFX_ITEM_ACTIVE,
+    GFX_ITEM_RELEASE,
+} gfx_its;
+
+// NOTE: The item is under the cursor when it was the topmost one there in the previous frame
+static int gfxProcessItem(gfx_id Item, v2f TL, v2f BR)
+{
+    gfxHitRecord(Item, TL, BR);
+
+    if(GfxHover == Item)
+    {
+        if(GfxBtn)
+        {
+            if(GfxHot == 0 || GfxHot == Item)
+            {
+                GfxHot = Item;
+
+                return GFX_ITEM_ACTIVE;
+            }
+            else
+            {
+                return GFX_ITEM_IDLE;
+            }
+        }
+        else
+        {
+            if(GfxHot == Item)
+            {
+                return GFX_ITEM_RELEASE;
+            }
+            else
+            {
+                return GFX_ITEM_HOVER;
+            }
+        }
+    }
+    else
+    {
+        return GFX_ITEM_IDLE;
+    }
+}
+
+static b32 gfxButton(const char* Text)
+{
+    GFX_TRACE_BEGIN("gfxButton");
+
+    b32 Result = 0;
+
+    usz Len = gfxTextCols(Text, strlen(Text));
+
+    v2f TL, BR;
+    TL[0] = GfxPos[0];
+    TL[1] = GfxPos[1];
+    BR[0] = GfxPos[0] + (Len + 1) * GfxFnt.Cols;
+    BR[1] = GfxPos[1] + GfxFnt.Rows;
+
+    if(!gfxVisible(TL[0], TL[1], BR[0], BR[1]))
+    {
+        GfxPos[1] += GfxFnt.Rows + GfxSep;
+        GFX_TRACE_END("gfxButton");
+        return Result;
+    }
+
+    switch(gfxProcessItem(gfxId(Text), TL, BR))
+    {
+        case GFX_ITEM_IDLE:   gfxColorRGB8(44, 74, 114);  break;
+        case GFX_ITEM_ACTIVE: gfxColorRGB8(15, 135, 250); break;
+        case GFX_ITEM_RELEASE:  Result = 1; // fallthrough
+        case GFX_ITEM_HOVER:  gfxColorRGB8(66, 150, 250); break;
+    }
+
+    gfxRect(TL[0], TL[1], BR[0], BR[1]);
+
+    GfxPos[0] += GfxFnt.Cols/2;
+
+    gfxColor3f(1.0f, 1.0f, 1.0f);
+    gfxString(Text);
+
+    GfxPos[0] -= GfxFnt.Cols/2;
+
+    GFX_TRACE_END("gfxButton");
+    return Result;
+}
+
+static b32 gfxRadioButton(const char* Text, i32* Value, i32 Target)
+{
+    GFX_TRACE_BEGIN("gfxRadioButton");
+
+    b32 Result = 0;
+
+    usz Len = gfxTextCols(Text, strlen(Text));
+
+    v2f TL, BR;
+    TL[0] = GfxPos[0];
+    TL[1] = GfxPos[1];
+    BR[0] = GfxPos[0] + GfxFnt.Rows + (Len + 0.5f) * GfxFnt.Cols;
+    BR[1] = GfxPos[1] + GfxFnt.Rows;
+
+    f32 R = GfxFnt.Rows * 0.5f;
+
+    if(!gfxVisible(TL[0], TL[1], BR[0], BR[1]))
+    {
+        GfxPos[1] += GfxFnt.Rows + GfxSep;
+        GFX_TRACE_END("gfxRadioButton");
+        return Result;
+    }
+
+    switch(gfxProcessItem(gfxId(Text), TL, BR))
+    {
+        case GFX_ITEM_IDLE:   gfxColorRGB8(33, 51, 77);  break;
+        case GFX_ITEM_ACTIVE: gfxColorRGB8(51, 107, 174); break;
+        case GFX_ITEM_RELEASE:  *Value = Target; Result = 1; // fallthrough
+        case GFX_ITEM_HOVER:  gfxColorRGB8(40, 74, 114); break;
+    }
+
+    gfxPolygon(GfxPos[0] + R, GfxPos[1] + R, R, 10);
+
+    if(*Value == Target)
+    {
+        gfxColorRGB8(66, 150, 250);
+
+        gfxPolygon(GfxPos[0] + R, GfxPos[1] + R, R*0.6f, 10);
+    }
+
+    GfxPos[0] += GfxFnt.Rows + GfxFnt.Cols/2;
+
+    gfxColor3f(1.0f, 1.0f, 1.0f);
+
+    gfxString(Text);
+
+    GfxPos[0] -= GfxFnt.Rows + GfxFnt.Cols/2;
+
+    GFX_TRACE_END("gfxRadioButton");
+    return Result;
+}
+
+static void gfxCheckmark(f32 X, f32 Y, f32 M)
+{
+    // TODO: SIMD
+    f32 Ax = X + 0.15f * M, Ay = Y + 0.40f * M;
+    f32 Bx = X + 0.45f * M, By = Y + 0.80f * M;
+    f32 Cx = X + 0.80f * M, Cy = Y + 0.20f * M;
+    f32 Dx = X + 0.40f * M, Dy = Y + 0.55f * M;
+
+    gfxTriangle(Ax, Ay, Bx, By, Dx, Dy);
+    gfxTriangle(Dx, Dy, Bx, By, Cx, Cy);
+}
+
+static b32 gfxCheckBox(const char* Text, b32* Value)
+{
+    GFX_TRACE_BEGIN("gfxCheckBox");
+
+    b32 Result = 0;
+
+    usz Len = gfxTextCols(Text, strlen(Text));
+
+    v2f TL, BR, MR;
+
+    TL[0] = GfxPos[0];
+    TL[1] = GfxPos[1];
+
+    MR[0] = GfxPos[0] + GfxFnt.Rows;
+    MR[1] = GfxPos[1] + GfxFnt.Rows;
+
+    BR[0] = MR[0] + (Len + 0.5f) * GfxFnt.Cols;
+    BR[1] = MR[1];
+
+    if(!gfxVisible(TL[0], TL[1], BR[0], BR[1]))
+    {
+        GfxPos[1] += GfxFnt.Rows + GfxSep;
+        GFX_TRACE_END("gfxCheckBox");
+        return Result;
+    }
+
+    switch(gfxProcessItem(gfxId(Text), TL, BR))
+    {
+        case GFX_ITEM_IDLE:   gfxColorRGB8(33, 51, 77);  break;
+        case GFX_ITEM_ACTIVE: gfxColorRGB8(51, 107, 174); break;
+        case GFX_ITEM_RELEASE:  *Value = !*Value; Result = 1; // fallthrough
+        case GFX_ITEM_HOVER:  gfxColorRGB8(40, 74, 114); break;
+    }
+
+    gfxRect(TL[0], TL[1], MR[0], MR[1]);
+
+    if(*Value)
+    {
+        gfxColorRGB8(66, 150, 250);
+
+#if 0
+        gfxRect(TL[0] + 0.20f * GfxFnt.Rows, TL[1] + 0.20f * GfxFnt.Rows,
+                TL[0] + 0.80f * GfxFnt.Rows, TL[1] + 0.80f * GfxFnt.Rows);
+#else
+        gfxCheckmark(TL[0], TL[1], (f32)GfxFnt.Rows);
+#endif
+    }
+
+    GfxPos[0] += GfxFnt.Rows + GfxFnt.Cols/2;
+
+    gfxColor3f(1.0f, 1.0f, 1.0f);
+
+    gfxString(Text);
+
+    GfxPos[0] -= GfxFnt.Rows + GfxFnt.Cols/2;
+
+    GFX_TRACE_END("gfxCheckBox");
+    return Result;
+}
+
+static b32 gfxSliderFloat(f32 A, f32 B, f32* V, const char* Text)
+{
+    GFX_TRACE_BEGIN("gfxSliderFloat");
+
+    b32 Result = 0;
+
+    v2f STL, SBR;
+    STL[0] = GfxPos[0];
+    STL[1] = GfxPos[1];
+    SBR[0] = STL[0] + 300;
+    SBR[1] = STL[1] + GfxFnt.Rows;
+
+    if(!gfxVisible(STL[0], STL[1], SBR[0], SBR[1]))
+    {
+        GfxPos[1] += GfxFnt.Rows + GfxSep;
+        GFX_TRACE_END("gfxSliderFloat");
+        return Result;
+    }
+
+    gfx_id Id = gfxIdPtr(V);
+
+    if(GfxPrevHot == Id)
+    {
+        f32 Mult = GfxKeyShift ? 10.0f : 100.0f;
+        f32 Speed = (B - A) / Mult;
+
+        // NOTE: One step per key press, so the speed does not depend on the frame rate
+        if(GfxKeyLeft) *V = Max(*V - Speed * GfxKeyLeft, A);
+        if(GfxKeyRight) *V = Min(*V + Speed * GfxKeyRight, B);
+
+        Result = 1;
+    }
+
+    if(GfxHot == Id)
+    {
+        gfxColor4f(0.8f, 0.8f, 0.8f, 0.8f);
+
+        f32 Value = A + (GfxCur[0] - GfxState.Offset[0] - STL[0]) * (B - A) / (SBR[0] - STL[0]);
+
+        *V = Clamp(A, B, Value);
+
+        Result = 1;
+    }
+
+    gfxColorRGB8(64, 68, 71);
+    gfxRect(STL[0], STL[1], SBR[0], SBR[1]);
+
+    usz Length;
+    char* Buffer = gfxArenaFormat(GfxFrameArena, &Length, Text, *V);
+
+    GfxPos[0] = (SBR[0] + STL[0] - gfxTextCols(Buffer, Length) * GfxFnt.Cols) * 0.5f;
+    gfxColor3f(1.0f, 1.0f, 1.0f);
+    gfxText(Buffer, Length);
+    GfxPos[0] = STL[0];
+
+    f32 Width = 25.0f;
+    f32 Offset = (SBR[0] - STL[0] - Width) * (*V - A) / (B - A);
+
+    v2f BTL, BBR;
+    BTL[0] = STL[0] + Offset;
+    BTL[1] = STL[1];
+    BBR[0] = BTL[0] + Width;
+    BBR[1] = SBR[1];
+
+    switch(gfxProcessItem(Id, BTL, BBR))
+    {
+        case GFX_ITEM_IDLE:    gfxColor4f(0.5f, 0.5f, 0.5f, 0.5f); break;
+        case GFX_ITEM_ACTIVE:  gfxColor4f(0.8f, 0.8f, 0.8f, 0.8f); break;
+        case GFX_ITEM_RELEASE: // fallthrough
+        case GFX_ITEM_HOVER:   gfxColor4f(0.7f, 0.7f, 0.7f, 0.7f); break;
+    }
+
+    gfxRect(BTL[0], BTL[1], BBR[0], BBR[1]);
+
+    GFX_TRACE_END("gfxSliderFloat");
+    return Result;
+}
+
+static v2f GfxGroups[GFX_STACK_DEPTH]; // Layout position after every open group box
+static u32 GfxGroupCount;
+
+// NOTE: Children are clipped to the inside of the box, returns 0 when none of them can be visible.
+// Every call must be matched by gfxGroupBoxEnd, whatever it returns.
+static b32 gfxGroupBox(const char* Title, f32 Cols, f32 Rows)
+{
+    GFX_TRACE_BEGIN("gfxGroupBox");
+
+    f32 X1 = GfxPos[0];
+    f32 Y1 = GfxPos[1] + GfxFnt.Rows/2;
+    f32 X2 = X1 + Cols;
+    f32 Y2 = Y1 + Rows;
+
+    Assert(GfxGroupCount < GFX_STACK_DEPTH);
+    v2f* Group = &GfxGroups[GfxGroupCount++];
+    (*Group)[0] = X1;
+    (*Group)[1] = Y2 + GfxSep;
+
+    b32 Result = gfxVisible(X1, Y1, X2, Y2);
+    if(Result)
+    {
+        gfxColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+        gfxRectLines(X1, Y1, X2, Y2);
+
+        GfxPos[0] += GfxSep / 2;
+        gfxString(Title);
+        GfxPos[0] += GfxSep / 2; // IMPORTANT
+    }
+
+    gfxPushClip(X1 + 1.0f, Y1 + 1.0f, X2 - 1.0f, Y2 - 1.0f);
+
+    GFX_TRACE_END("gfxGroupBox");
+    return Result;
+}
+
+static void gfxGroupBoxEnd(void)
+{
+    gfxPop();
+
+    Assert(GfxGroupCount > 0);
+    v2f* Group = &GfxGroups[--GfxGroupCount];
+    GfxPos[0] = (*Group)[0];
+    GfxPos[1] = (*Group)[1];
+}
+
+static b32 gfxProgressBar(f32 Left, f32 Right, f32* V, const char* Fmt)
+{
+    GFX_TRACE_BEGIN("gfxProgressBar");
+
+    b32 Result = 0;
+
+    f32 X1 = GfxPos[0];
+    f32 Y1 = GfxPos[1];
+    f32 X2 = X1 + 200;
+    f32 Y2 = Y1 + GfxFnt.Rows;
+
+    if(!gfxVisible(X1, Y1, X2, Y2))
+    {
+        GfxPos[1] += GfxFnt.Rows + GfxSep;
+        GFX_TRACE_END("gfxProgressBar");
+        return Result;
+    }
+
+    f32 XM = X1 + (X2 - X1) * (*V - Left) / (Right - Left);
+
+    gfxColor3f(32/255.f, 50/255.f, 77/255.f);
+    gfxRect(X1, Y1, X2, Y2);
+
+    gfxColor3f(61/255.f, 132/255.f, 221/255.f);
+    gfxRect(X1+1, Y1+1, XM-1, Y2-1);
+
+    if(!Fmt)
+    {
+        Fmt = "%.1lf";
+    }
+
+    gfxColor3f(1.f, 1.f, 1.f);
+
+    usz Length;
+    char* Buffer = gfxArenaFormat(GfxFrameArena, &Length, Fmt, *V);
+    GfxPos[0] = (X2 + X1 - gfxTextCols(Buffer, Length) * GfxFnt.Cols) / 2.f;
+    gfxText(Buffer, Length);
+    GfxPos[0] = X1;
+
+    GFX_TRACE_END("gfxProgressBar");
+    return Result;
+}
+
+// NOTE: Clicking the box opens a popup with the choices below it, picking one returns 1
+static b32 gfxComboBox(const char** Choice, const char** Array, usz Count)
+{
+    GFX_TRACE_BEGIN("gfxComboBox");
+
+    b32 Result = 0;
+
+    v2f TL, BR;
+    TL[0] = GfxPos[0];
+    TL[1] = GfxPos[1];
+    BR[0] = GfxPos[0] + 300;
+    BR[1] = GfxPos[1] + GfxFnt.Rows;
+
+    if(!gfxVisible(TL[0], TL[1], BR[0], BR[1]))
+    {
+        GfxPos[1] += GfxFnt.Rows + GfxSep;
+        GFX_TRACE_END("gfxComboBox");
+        return Result;
+    }
+
+    gfx_id Id = gfxIdPtr(Choice);
+    gfx_widget* Widget = gfxWidget(Id);
+
+    switch(gfxProcessItem(Id, TL, BR))
+    {
+        case GFX_ITEM_IDLE:   gfxColorRGB8(44, 74, 114);  break;
+        case GFX_ITEM_ACTIVE: gfxColorRGB8(15, 135, 250); break;
+        case GFX_ITEM_RELEASE:  Widget->Open = !Widget->Open; // fallthrough
+        case GFX_ITEM_HOVER:  gfxColorRGB8(66, 150, 250); break;
+    }
+
+    gfxRect(TL[0], TL[1], BR[0], BR[1]);
+    gfxColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+    gfxTriangle(BR[0] - 1.5f * GfxFnt.Cols, TL[1] + GfxFnt.Rows * 0.25f,
+                BR[0] - 0.5f * GfxFnt.Cols, TL[1] + GfxFnt.Rows * 0.25f,
+                BR[0] - 1.0f * GfxFnt.Cols, BR[1] - GfxFnt.Rows * 0.25f);
+
+    GfxPos[0] += GfxFnt.Cols/2;
+    gfxString(*Choice);
+    GfxPos[0] -= GfxFnt.Cols/2;
+
+    if(Widget->Open)
+    {
+        v2f LTL, LBR;
+        LTL[0] = TL[0];
+        LTL[1] = BR[1];
+        LBR[0] = BR[0];
+        LBR[1] = BR[1] + Count * GfxFnt.Rows;
+
+        // NOTE: Pressing anywhere outside of the box and the list closes it
+        v2f Cur;
+        Cur[0] = GfxCur[0] - GfxState.Offset[0];
+        Cur[1] = GfxCur[1] - GfxState.Offset[1];
+        if(GfxBtn && !gfxPointInRect(Cur, TL, BR) && !gfxPointInRect(Cur, LTL, LBR))
+        {
+            Widget->Open = 0;
+        }
+
+        v2f Pos;
+        Pos[0] = GfxPos[0];
+        Pos[1] = GfxPos[1];
+
+        gfxBeginPopup();
+
+        for(usz Idx = 0; Idx < Count; Idx++)
+        {
+            v2f OTL, OBR;
+            OTL[0] = LTL[0];
+            OTL[1] = LTL[1] + Idx * GfxFnt.Rows;
+            OBR[0] = LBR[0];
+            OBR[1] = OTL[1] + GfxFnt.Rows;
+
+            switch(gfxProcessItem(gfxHash(&Idx, sizeof(Idx), Id), OTL, OBR))
+            {
+                case GFX_ITEM_IDLE:   gfxColorRGB8(32, 50, 77);  break;
+                case GFX_ITEM_ACTIVE: gfxColorRGB8(15, 135, 250); break;
+                case GFX_ITEM_RELEASE:  *Choice = Array[Idx]; Widget->Open = 0; Result = 1; // fallthrough
+                case GFX_ITEM_HOVER:  gfxColorRGB8(66, 150, 250); break;
+            }
+
+            gfxRect(OTL[0], OTL[1], OBR[0], OBR[1]);
+
+            GfxPos[0] = OTL[0] + GfxFnt.Cols/2;
+            GfxPos[1] = OTL[1];
+            gfxColor3f(1.0f, 1.0f, 1.0f);
+            gfxString(Array[Idx]);
+        }
+
+        gfxEndPopup();
+
+        // NOTE: The list floats above, so it takes no room in the layout
+        GfxPos[0] = Pos[0];
+        GfxPos[1] = Pos[1];
+    }
+
+    GFX_TRACE_END("gfxComboBox");
+    return Result;
+}
+
+static int gfxMsCompare(const void* A, const void* B)
+{
+    f32 X = *(const f32*)A;
+    f32 Y = *(const f32*)B;
+    return (X > Y) - (X < Y);
+}
+
+// NOTE: Graph of the work time of recent frames and counters of the previous frame, drawn at the layout position
+static void gfxOverlay(void)
+{
+    GFX_TRACE_BEGIN("gfxOverlay");
+
+    f32 X1 = GfxPos[0];
+    f32 Y1 = GfxPos[1];
+    f32 X2 = X1 + 27 * GfxFnt.Cols;
+    f32 GraphRows = 64.0f;
+    f32 LineRows = (f32) GfxFnt.Rows; // Lines are packed tighter than regular text
+    f32 Y2 = Y1 + GraphRows + 4 * LineRows + 3 * GfxSep / 2;
+
+    if(!gfxVisible(X1, Y1, X2, Y2))
+    {
+        GfxPos[1] = Y2 + GfxSep;
+        GFX_TRACE_END("gfxOverlay");
+        return;
+    }
+
+    gfxColor4f(0.0f, 0.0f, 0.0f, 0.7f);
+    gfxRect(X1, Y1, X2, Y2);
+    gfxColor4f(0.5f, 0.5f, 0.5f, 1.0f);
+    gfxRectLines(X1, Y1, X2, Y2);
+
+    // NOTE: The current frame is not done yet, so the graph ends at the previous one
+    u32 Count = (u32) Min(GfxFrame, GFX_STATS_FRAMES);
+    f32 Sorted[GFX_STATS_FRAMES];
+    f32 Sum = 0.0f;
+    for(u32 Idx = 0; Idx < Count; Idx++)
+    {
+        Sorted[Idx] = GfxFrameMs[(GfxFrame - 1 - Idx) % GFX_STATS_FRAMES];
+        Sum += Sorted[Idx];
+    }
+
+    // NOTE: Newest frame on the right, the full height is 33.3 ms
+    f32 GraphX = X1 + GfxSep / 2;
+    f32 GraphY = Y1 + GfxSep / 2 + GraphRows;
+    f32 BarCols = (X2 - X1 - GfxSep) / GFX_STATS_FRAMES;
+    for(u32 Idx = 0; Idx < Count; Idx++)
+    {
+        f32 Ms = Sorted[Idx];
+        // NOTE: Blue fits the budget of 60 Hz, yellow of 30 Hz
+        if(Ms < 17.5f)      gfxColorRGB8(61, 132, 221);
+        else if(Ms < 34.5f) gfxColorRGB8(221, 180, 61);
+        else                gfxColorRGB8(221, 61, 61);
+
+        f32 BarX = GraphX + (GFX_STATS_FRAMES - 1 - Idx) * BarCols;
+        f32 BarRows = Min(Ms * GraphRows / (1000.0f / 30.0f), GraphRows);
+        gfxRect(BarX, GraphY - BarRows, BarX + BarCols, GraphY);
+    }
+
+    gfxColor4f(0.3f, 0.3f, 0.3f, 0.3f);
+    gfxRect(GraphX, GraphY - GraphRows / 2, X2 - GfxSep / 2, GraphY - GraphRows / 2 + 1);
+
+    qsort(Sorted, Count, sizeof(f32), gfxMsCompare);
+
+    f32 P50 = Count ? Sorted[(Count - 1) * 50 / 100] : 0.0f;
+    f32 P90 = Count ? Sorted[(Count - 1) * 90 / 100] : 0.0f;
+    f32 P99 = Count ? Sorted[(Count - 1) * 99 / 100] : 0.0f;
+    f32 Mean = Count ? Sum / Count : 0.0f;
+
+    char* Lines[4];
+    usz Lengths[4];
+    Lines[0] = gfxArenaFormat(GfxFrameArena, &Lengths[0], "work %.2f ms", Mean);
+    Lines[1] = gfxArenaFormat(GfxFrameArena, &Lengths[1], "p50 %.1f p90 %.1f p99 %.1f", P50, P90, P99);
+    Lines[2] = gfxArenaFormat(GfxFrameArena, &Lengths[2], "draws %u verts %u", GfxStatsLast.DrawCalls, GfxStatsLast.Vertices);
+    Lines[3] = gfxArenaFormat(GfxFrameArena, &Lengths[3], "binds %u glyphs %u", GfxStatsLast.Binds, GfxStatsLast.Glyphs);
+
+    gfxColor3f(1.0f, 1.0f, 1.0f);
+    for(u32 Line = 0; Line < ArrLen(Lines); Line++)
+    {
+        GfxPos[0] = X1 + GfxSep / 2;
+        GfxPos[1] = GraphY + GfxSep / 2 + Line * LineRows;
+        gfxText(Lines[Line], Lengths[Line]);
+    }
+
+    GfxPos[0] = X1;
+    GfxPos[1] = Y2 + GfxSep;
+
+    GFX_TRACE_END("gfxOverlay");
+}
+
+//
+// TEXT VIEW
+//
+
+#define GFX_VIEW_STEP 256 // Lines between two checkpoints of the line index
+#define GFX_VIEW_BLOCK 0x1000 // Checkpoints added to the index at once
+#define GFX_VIEW_TAB 8
+#define GFX_VIEW_POLL_MS 100 // Frame interval while following a file
+#define GFX_VIEW_RESERVE ((usz)1 << 36) // Address space of a followed file
+#define GFX_VIEW_READ ((usz)1 << 24) // Bytes of a followed file read in a frame at most
+#define GFX_VIEW_HIT 0xFF1E5A8C // Background of found text
+
+#define GFX_FIND_MAX 64 // Longest text searched for
+#define GFX_FIND_CHUNK ((usz)1 << 22) // Bytes searched between publishing hits
+#define GFX_FIND_BLOCK 0x10000 // Hits added to the index at once
+#define GFX_FIND_LIMIT ((u32)1 << 24) // Hits kept at most, the search ends there
+
+// NOTE: Search of a view runs on its own thread and publishes hits in file order, the view reads only those
+// around the drawn lines
+typedef struct
 {
-    b32 Result = 0;
+    char Text[GFX_FIND_MAX];
+    u32 Size;
+    b32 Running;
+    gfx_thread Thread; // Searches, then waits on Wake for more of the file
+    gfx_sem Wake;
+    gfx_arena Arena; // Storage of the hits, which never move
+    u64* Hits; // Offsets of the text, sorted
+    u32 Cap;
+    volatile u32 Count; // Hits published by the thread
+    volatile u32 Done; // Set by the thread once the whole file is searched, the thread is then waiting
+    volatile u32 Stop;
+    usz Next; // First offset not searched yet, used by the thread
+} gfx_find;
+
+// NOTE: The file is mapped and the index keeps only every GFX_VIEW_STEP-th line start, about 32 bytes per
+// thousand lines, so opening is immediate and drawing touches only the lines in the view. A followed file is
+// read into memory of the view instead, as others may truncate it, and appended bytes are indexed as they
+// come.
+typedef struct
+{
+    const char* Name; // Kept for following, owned by the application
+    const char* Data; // Mapped file, or bytes read so far when following
+    usz Size;
+    usz Committed;
+    gfx_stamp Stamp; // Of the followed file when it was read last
+    gfx_thread Thread; // Builds the index, then waits on Wake for more of the file
+    gfx_sem Wake;
+    gfx_arena Arena; // Storage of the index, which never moves
+    u64* Index; // Offset of lines 0, GFX_VIEW_STEP, 2*GFX_VIEW_STEP...
+    u32 Cap;
+    volatile u32 Count; // Checkpoints published by the thread, at least one
+    volatile u32 Done; // Set by the thread once Lines is valid, the thread is then waiting
+    volatile u32 Stop;
+    u64 Lines;
+    u64 Known; // Lines shown so far, does not shrink while the index is extended
+    b32 Follow;
+    b32 Tail; // Drawn up to the last line, so appended lines scroll into the view
+    b32 Changed; // File changed while the threads were busy, or more of it is left to read
+    b32 Stale; // Grid must be filled again at the same first line
+    b32 Watching;
+    gfx_watch Watch;
+    gfx_find Find;
+    u32 Marked; // Hits looked at when the grid was filled
+    usz GridBegin; // Bytes in the grid
+    usz GridEnd;
+    u64 First; // First drawn line
+    u64 Shown; // First line in the grid, ~0 when the grid must be filled again
+    gfx_grid Grid;
+} gfx_view;
+
+// NOTE: Skips up to *Count line breaks, returns the offset after the last one skipped and leaves in *Count
+// the number of those not found
+static usz gfxScanLines(const char* Data, usz Size, u32* Count)
+{
+    usz Idx = 0;
+    u32 Left = *Count;
 
-    if(Str->Sz)
+#if GFX_SIMD
+    // NOTE: Breaks of 64 bytes are counted at once, only the block with the one looked for is walked
+    __m128i Break = _mm_set1_epi8('\n');
+    for(; Left && Idx + 64 <= Size; Idx += 64)
     {
-        while(Str->Sz && *Str->At == ' ')
+        const __m128i* At = (const __m128i*) (Data + Idx);
+        u64 Mask0 = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(At + 0), Break));
+        u64 Mask1 = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(At + 1), Break));
+        u64 Mask2 = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(At + 2), Break));
+        u64 Mask3 = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(At + 3), Break));
+        u64 Mask = Mask0 | (Mask1 << 16) | (Mask2 << 32) | (Mask3 << 48);
+
+        u32 Found = gfxBitCount(Mask);
+        if(Found < Left)
         {
-            Str->Sz--;
-            Str->At++;
+            Left -= Found;
+            continue;
         }
 
-        Token->At = Str->At;
-
-        while(Str->Sz && *Str->At != ' ')
+        while(--Left)
         {
-            Str->At++;
-            Str->Sz--;
+            Mask &= Mask - 1;
         }
 
-        Token->Sz = Str->At - Token->At;
-
-        Result = 1;
+        *Count = 0;
+        return Idx + gfxBitScan(Mask) + 1;
     }
+#endif
 
-    return Result;
-}
-
-static b32 gfxParseLine(gfx_str* Str, gfx_str* Tokens, usz Count)
-{
-    b32 Result = 0;
-
-    gfx_str Line;
-    if(gfxGetLine(Str, &Line))
+    for(; Left && Idx < Size; Idx++)
     {
-        usz Idx = 0;
-        while(Idx < Count && gfxTokenize(&Line, &Tokens[Idx]))
+        if(Data[Idx] == '\n')
         {
-            Idx++;
+            Left--;
         }
-
-        Result = 1;
     }
 
-    return Result;
+    *Count = Left;
+    return Idx;
 }
 
-static b32 gfxReadFnt(gfx_fnt* Fnt, gfx_str* Str)
+// NOTE: Writes offsets of Text that start from *From up to To into Hits, stops early once Max are found and
+// leaves in *From where to go on. Data must hold Size - 1 bytes past To.
+static u32 gfxSearch(const char* Data, usz* From, usz To, const char* Text, u32 Size, u64* Hits, u32 Max)
 {
-    gfx_str Tokens[8] = {0};
-    if(gfxParseLine(Str, Tokens, ArrLen(Tokens)) &&
-       gfxStrEqu(&Tokens[0], "STARTFONT"))
+    u32 Found = 0;
+    usz Idx = *From;
+
+#if GFX_SIMD
+    // NOTE: Only offsets matching both the first and the last byte of the text are compared in full
+    __m128i Head = _mm_set1_epi8(Text[0]);
+    __m128i Tail = _mm_set1_epi8(Text[Size - 1]);
+    for(; Idx + 64 <= To; Idx += 64)
     {
-        while(1) // TODO: Break it
+        u64 Mask = 0;
+        for(u32 Part = 0; Part < 4; Part++)
         {
-            if(!gfxParseLine(Str, Tokens, ArrLen(Tokens)))
-            {
-                // TODO: Logging
-                return 0;
-            }
+            const char* At = Data + Idx + Part * 16;
+            __m128i First = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) At), Head);
+            __m128i Last = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (At + Size - 1)), Tail);
+            Mask |= (u64)(u32) _mm_movemask_epi8(_mm_and_si128(First, Last)) << (Part * 16);
+        }
 
-            if(gfxStrEqu(Tokens+0, "FONTBOUNDINGBOX"))
-            {
-                if(!gfxStrToU32(Tokens+1, &Fnt->Cols) ||
-                   !gfxStrToU32(Tokens+2, &Fnt->Rows))
-                {
-                    // TODO: Logging
-                    return 0;
-                }
-            }
-            else if(gfxStrEqu(Tokens+0, "CHARS"))
+        for(; Mask; Mask &= Mask - 1)
+        {
+            usz At = Idx + gfxBitScan(Mask);
+            if(memcmp(Data + At, Text, Size) == 0)
             {
-                if(Fnt->Data)
+                if(Found == Max)
                 {
-                    gfxVirtualFree(Fnt->Data);
+                    *From = At;
+                    return Found;
                 }
 
-                Fnt->Skip = Fnt->Cols * 4 * sizeof(f32);
-                Fnt->Jump = Fnt->Skip * Fnt->Rows;
-                Fnt->Size = Fnt->Jump * 256;
-                Fnt->Data = gfxVirtualAlloc(Fnt->Size);
-                if(!Fnt->Data)
-                {
-                    // TODO: Logging
-                    return 0;
-                }
+                Hits[Found++] = At;
             }
-            else if(gfxStrEqu(Tokens+0, "STARTCHAR"))
-            {
-                u32 Encoding = 0;
-                while(1) // TODO: Break it
-                {
-                    if(!gfxParseLine(Str, Tokens, ArrLen(Tokens)))
-                    {
-                        // TODO: Logging
-                        return 0;
-                    }
-
-                    if(gfxStrEqu(Tokens+0, "ENCODING"))
-                    {
-                        if(!gfxStrToU32(Tokens+1, &Encoding))
-                        {
-                            // TODO: Logging
-                            return 0;
-                        }
-
-                        if(Encoding >= 256)
-                        {
-                            // TODO: Handle more chars
-                            break;
-                        }
-                    }
-                    else if(gfxStrEqu(Tokens+0, "BITMAP"))
-                    {
-                        u32 Bytes = ((Fnt->Cols + 7) / 8);
-                        f32* PixelAt = (f32*) (Fnt->Data + Encoding * Fnt->Jump);
-                        for(u32 Row = 0; Row < Fnt->Rows; Row++)
-                        {
-                            gfx_str Line;
-                            if(!gfxGetLine(Str, &Line))
-                            {
-                                // TODO: Logging
-                                return 0;
-                            }
-
-                            if(Line.Sz < 2*Bytes)
-                            {
-                                // TODO: Logging
-                                return 0;
-                            }
-
-                            for(u32 Idx = 0; Idx < Bytes; Idx++)
-                            {
-                                u8 Hi = 0, Lo = 0;
-                                if(!gfxHexToDec(Line.At[2*Idx+0], &Hi) ||
-                                   !gfxHexToDec(Line.At[2*Idx+1], &Lo))
-                                {
-                                    // TODO: Logging
-                                    return 0;
-                                }
+        }
+    }
+#endif
 
-                                u8 Val = (Hi << 4) | Lo;
-                                u32 Left = Fnt->Cols - Idx * 8;
-                                u32 Iters = (Left > 8) ? 8 : Left;
-                                for(u32 Jdx = 0; Jdx < Iters; Jdx++)
-                                {
-                                    f32 V = (Val & 0x80) ? 1.0f : 0.0f;
-                                    *(PixelAt++) = V;
-                                    *(PixelAt++) = V;
-                                    *(PixelAt++) = V;
-                                    *(PixelAt++) = V;
-                                    Val <<= 1;
-                                }
-                            }
-                        }
-                    }
-                    else if(gfxStrEqu(Tokens+0, "ENDCHAR"))
-                    {
-                        break;
-                    }
-                }
-            }
-            else if(gfxStrEqu(Tokens+0, "ENDFONT"))
+    for(; Idx < To; Idx++)
+    {
+        if(Data[Idx] == Text[0] && memcmp(Data + Idx, Text, Size) == 0)
+        {
+            if(Found == Max)
             {
                 break;
             }
+
+            Hits[Found++] = Idx;
         }
     }
 
-    return 1;
+    *From = Idx;
+    return Found;
 }
 
-static b32 gfxLoadBdf(gfx_fnt* Fnt, const char* Name)
+// NOTE: Runs on the view thread and publishes every checkpoint, so the view scrolls through the part scanned
+// so far while the rest is being indexed. Every pass starts at the last checkpoint, so appended bytes cost
+// at most GFX_VIEW_STEP lines more than themselves.
+static void gfxViewIndex(void* Param)
 {
-    b32 Result = 0;
+    gfx_view* View = (gfx_view*) Param;
 
-    usz Size = 0;
-    i8* Data = gfxLoadFile(Name, &Size);
-    if(Data)
+    while(!gfxAtomicLoad(&View->Stop))
     {
-        Data[Size] = 0;
-
-        gfx_str Buf = {0};
-        Buf.Sz = Size;
-        Buf.At = Data;
-        if(gfxReadFnt(Fnt, &Buf))
-        {
-            GLuint Texture;
-            glGenTextures(1, &Texture);
-            glBindTexture(GL_TEXTURE_2D, Texture);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, Fnt->Cols * 1, Fnt->Rows * 256, 0, GL_RGBA, GL_FLOAT, Fnt->Data);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
-            glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-            glBindTexture(GL_TEXTURE_2D, 0);
-            Fnt->Texture = Texture;
-            Result = 1;
-        }
-        else
+        u32 Count = View->Count;
+        u64 Breaks = (u64)(Count - 1) * GFX_VIEW_STEP;
+        usz Offset = View->Index[Count - 1];
+        while(!gfxAtomicLoad(&View->Stop))
         {
-            if(Fnt->Data)
+            u32 Left = GFX_VIEW_STEP;
+            Offset += gfxScanLines(View->Data + Offset, View->Size - Offset, &Left);
+            Breaks += GFX_VIEW_STEP - Left;
+            if(Left || Offset == View->Size)
+            {
+                // NOTE: Text after the last break is one more line
+                View->Lines = Breaks + (View->Size && View->Data[View->Size - 1] != '\n');
+                gfxAtomicStore(&View->Done, 1);
+                break;
+            }
+
+            if(Count == View->Cap)
             {
-                gfxVirtualFree(Fnt->Data);
+                u64* Block = gfxArenaPush(&View->Arena, GFX_VIEW_BLOCK * sizeof(u64));
+                Assert(Block == View->Index + View->Cap);
+                View->Cap += GFX_VIEW_BLOCK;
             }
+
+            View->Index[Count++] = Offset;
+            gfxAtomicStore(&View->Count, Count);
         }
 
-        gfxVirtualFree(Data);
+        gfxSemWait(&View->Wake);
     }
-
-    return Result;
 }
 
-typedef struct
+// NOTE: Runs on the search thread and publishes hits after every GFX_FIND_CHUNK bytes. Like the index it
+// goes on from where it stopped when the file grows.
+static void gfxViewSearch(void* Param)
 {
-    u32 Cols;
-    u32 Rows;
-    u64 Jump;
-    u64 Size;
-    u8* Data;
-    u32 Texture;
-} gfx_img;
+    gfx_view* View = (gfx_view*) Param;
+    gfx_find* Find = &View->Find;
 
-#pragma pack(push, 1)
-typedef struct
-{
-    char Magic[2];
-    u32 FileSize;
-    u32 Reserved;
-    u32 DataOffset;
-} gfx_bmp_file_header;
+    while(!gfxAtomicLoad(&Find->Stop))
+    {
+        usz Size = View->Size;
+        usz To = (Size >= Find->Size) ? Size - Find->Size + 1 : 0;
+        u32 Count = Find->Count;
+        while(Find->Next < To && Count < GFX_FIND_LIMIT && !gfxAtomicLoad(&Find->Stop))
+        {
+            if(Count == Find->Cap)
+            {
+                u64* Block = gfxArenaPush(&Find->Arena, GFX_FIND_BLOCK * sizeof(u64));
+                Assert(Block == Find->Hits + Find->Cap);
+                Find->Cap += GFX_FIND_BLOCK;
+            }
 
-typedef struct
-{
-    u32 HeaderSize;
-    u32 BitmapWidth;
-    u32 BitmapHeight;
-    u16 ColorPlanes;
-    u16 BitsPerPixel;
-    u32 Compression;
-    u32 ImageSize;
-    u32 HorizontalRes;
-    u32 VerticalRes;
-    u32 PaletteColors;
-    u32 ColorsImportant;
-} gfx_bmp_info_header;
+            usz End = Min(To, Find->Next + GFX_FIND_CHUNK);
+            Count += gfxSearch(View->Data, &Find->Next, End, Find->Text, Find->Size, Find->Hits + Count, Find->Cap - Count);
+            gfxAtomicStore(&Find->Count, Count);
+        }
 
-typedef struct
+        gfxAtomicStore(&Find->Done, 1);
+        gfxSemWait(&Find->Wake);
+    }
+}
+
+static void gfxViewFindEnd(gfx_view* View)
 {
-    gfx_bmp_file_header FileHeader;
-    gfx_bmp_info_header InfoHeader;
-    // u8 Pixels[];
-} gfx_bmp;
-#pragma pack(pop)
+    gfx_find* Find = &View->Find;
+    if(Find->Running)
+    {
+        gfxAtomicStore(&Find->Stop, 1);
+        gfxSemPost(&Find->Wake, 1);
+        gfxThreadJoin(&Find->Thread);
+        gfxSemFree(&Find->Wake);
+        gfxArenaFree(&Find->Arena);
+    }
 
-static b32 gfxLoadBmp(gfx_img* Img, const char* Path)
+    memset(Find, 0, sizeof(*Find));
+    View->Marked = 0;
+    View->Stale = 1;
+}
+
+// NOTE: Starts searching for Text, which is copied, and drops the hits of the previous search. Empty text
+// only ends the search.
+static b32 gfxViewFind(gfx_view* View, const char* Text, usz Size)
 {
     b32 Result = 0;
 
-    gfx_buf Buf = gfxLoadBuf(Path);
-    if(Buf.At)
+    gfxViewFindEnd(View);
+
+    gfx_find* Find = &View->Find;
+    if(View->Data && Size && Size <= GFX_FIND_MAX)
     {
-        gfx_bmp* Bmp;
-        if(Buf.Sz > sizeof(*Bmp))
+        memcpy(Find->Text, Text, Size);
+        Find->Size = (u32) Size;
+        Find->Hits = gfxArenaPush(&Find->Arena, GFX_FIND_BLOCK * sizeof(u64));
+        Find->Cap = GFX_FIND_BLOCK;
+
+        Find->Thread.Proc = gfxViewSearch;
+        Find->Thread.Param = View;
+        if(gfxSemInit(&Find->Wake))
         {
-            Bmp = (gfx_bmp*) Buf.At;
-            if(Bmp->FileHeader.Magic[0] == 'B' &&
-               Bmp->FileHeader.Magic[1] == 'M' &&
-               Bmp->InfoHeader.HeaderSize == sizeof(Bmp->InfoHeader))
+            if(gfxThreadStart(&Find->Thread))
             {
-                Img->Cols = Bmp->InfoHeader.BitmapWidth;
-                Img->Rows = Bmp->InfoHeader.BitmapHeight;
-                Img->Jump = (((Img->Cols * 3) + 3) / 4) * 4;
-                Img->Size = Img->Jump * Img->Rows;
-                if(Buf.Sz >= Bmp->FileHeader.DataOffset + Img->Size)
-                {
-                    Img->Data = Buf.At + Bmp->FileHeader.DataOffset;
-                    glGenTextures(1, &Img->Texture);
-                    glBindTexture(GL_TEXTURE_2D, Img->Texture);
-                    glPixelStorei(GL_PACK_ROW_LENGTH, Img->Cols);
-                    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, Img->Cols, Img->Rows, 0, GL_BGR, GL_UNSIGNED_BYTE, Img->Data);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
-                    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-                    glBindTexture(GL_TEXTURE_2D, 0);
-                    Result = 1;
-                }
-                else
-                {
-                    // TODO: Logging
-                }
+                Find->Running = 1;
+                Result = 1;
             }
             else
             {
-                // TODO: Logging
+                gfxSemFree(&Find->Wake);
             }
         }
-        else
+
+        if(!Result)
         {
-            // TODO: Logging
+            gfxArenaFree(&Find->Arena);
+            memset(Find, 0, sizeof(*Find));
         }
     }
-    else
-    {
-        // TODO: Logging
-    }
-
-    return Result;
-}
-
-#include <immintrin.h>
-
-typedef float m4f[16];
-typedef float v4f[4];
-typedef float v2f[2];
-typedef float v3f[3];
-
-static void gfxIdentity(m4f M)
-{
-    _mm_store_ps(&M[4*0], _mm_setr_ps(1.0f, 0.0f, 0.0f, 0.0f));
-    _mm_store_ps(&M[4*1], _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f));
-    _mm_store_ps(&M[4*2], _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f));
-    _mm_store_ps(&M[4*3], _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
-}
-
-static void gfxTranslateX(m4f M, f32 X)
-{
-    M[4*3+0] += X;
-}
-
-static void gfxTranslateY(m4f M, f32 Y)
-{
-    M[4*3+1] += Y;
-}
-
-static void gfxTranslateZ(m4f M, f32 Z)
-{
-    M[4*3+2] += Z;
-}
-
-static void gfxTranslate(m4f M, v3f V)
-{
-    M[4*3+0] += V[0];
-    M[4*3+1] += V[1];
-    M[4*3+2] += V[2];
-}
-
-static void gfxScaleX(m4f M, f32 X)
-{
-    M[4*0+0] *= X;
-}
-
-static void gfxScaleY(m4f M, f32 Y)
-{
-    M[4*1+1] *= Y;
-}
 
-static void gfxScaleZ(m4f M, f32 Z)
-{
-    M[4*2+2] *= Z;
+    return Result;
 }
 
-static void gfxScale(m4f M, v3f V)
+static b32 gfxViewStart(gfx_view* View)
 {
-    M[4*0+0] *= V[0];
-    M[4*1+1] *= V[1];
-    M[4*2+2] *= V[2];
-}
+    b32 Result = 0;
 
-static void gfxOrtho(f32* M, f32 Left, f32 Right, f32 Bottom, f32 Top, f32 Near, f32 Far)
-{
-    M[0]  = 2.0f / (Right - Left);
-    M[1]  = 0.0f;
-    M[2]  = 0.0f;
-    M[3]  = 0.0f;
+    View->Index = gfxArenaPush(&View->Arena, GFX_VIEW_BLOCK * sizeof(u64));
+    View->Cap = GFX_VIEW_BLOCK;
+    View->Index[0] = 0;
+    View->Count = 1;
 
-    M[4]  = 0.0f;
-    M[5]  = 2.0f / (Top - Bottom);
-    M[6]  = 0.0f;
-    M[7]  = 0.0f;
+    View->Thread.Proc = gfxViewIndex;
+    View->Thread.Param = View;
+    if(gfxSemInit(&View->Wake))
+    {
+        if(gfxThreadStart(&View->Thread))
+        {
+            Result = 1;
+        }
+        else
+        {
+            gfxSemFree(&View->Wake);
+        }
+    }
 
-    M[8]  = 0.0f;
-    M[9]  = 0.0f;
-    M[10] = -2.0f / (Far - Near);
-    M[11] = 0.0f;
+    if(!Result)
+    {
+        gfxArenaFree(&View->Arena);
+        View->Index = 0;
+    }
 
-    M[12] = -(Right + Left) / (Right - Left);
-    M[13] = -(Top + Bottom) / (Top - Bottom);
-    M[14] = -(Far + Near) / (Far - Near);
-    M[15] = 1.0f;
+    return Result;
 }
 
-static gfx_fnt GfxFnt;
-static f32 GfxSep = 20.f;
-static v2f GfxPos = {0.0f, 0.0f};
-static v2f GfxCur = {0.0f, 0.0f};
-static b32 GfxBtn = 0;
-static f32 GfxCols;
-static f32 GfxRows;
-static const void* GfxHot = 0;
-static const void* GfxPrevHot = 0;
-static u8 GfxKeyLeft;
-static u8 GfxKeyRight;
-static u8 GfxKeyUp;
-static u8 GfxKeyDown;
-static u8 GfxKeyShift;
-
-static void gfxText(const char* Text, usz Size)
+static b32 gfxViewOpen(gfx_view* View, const char* Name)
 {
-    glBindTexture(GL_TEXTURE_2D, GfxFnt.Texture);
+    b32 Result = 0;
 
-    f32 X1 = GfxPos[0];
-    f32 Y1 = GfxPos[1];
+    memset(View, 0, sizeof(*View));
+    View->Name = Name;
+    View->Shown = ~(u64)0;
+    View->Data = gfxMapFile(Name, &View->Size);
+    if(View->Data)
+    {
+        if(gfxViewStart(View))
+        {
+            Result = 1;
+        }
+        else
+        {
+            gfxUnmapFile((void*) View->Data, View->Size);
+            View->Data = 0;
+        }
+    }
 
-    f32 X = GfxPos[0];
-    f32 Y2 = GfxPos[1] + GfxFnt.Rows;
+    return Result;
+}
 
-    glBegin(GL_TRIANGLES);
+// NOTE: The file need not exist yet. It is read a part at a time by gfxTextView, which starts drawing at the
+// end, clear Tail to start at the top.
+static b32 gfxViewFollow(gfx_view* View, const char* Name)
+{
+    b32 Result = 0;
 
-    for(usz Idx = 0; Idx < Size; Idx++)
+    memset(View, 0, sizeof(*View));
+    View->Name = Name;
+    View->Shown = ~(u64)0;
+    View->Follow = 1;
+    View->Tail = 1;
+    View->Changed = 1;
+    View->Data = gfxVirtualReserve(GFX_VIEW_RESERVE);
+    if(View->Data)
     {
-        char C = Text[Idx];
-
-        f32 rat = (C + 0) / 256.0f;
-        f32 bat = (C + 1) / 256.0f;
+        if(gfxViewStart(View))
+        {
+            Result = 1;
+        }
+        else
+        {
+            gfxVirtualRelease((void*) View->Data, GFX_VIEW_RESERVE);
+            View->Data = 0;
+        }
+    }
 
-        glTexCoord2f(0.0f, rat); glVertex2f(X, Y1);
-        glTexCoord2f(1.0f, rat); glVertex2f(X+GfxFnt.Cols, Y1);
-        glTexCoord2f(0.0f, bat); glVertex2f(X, Y2);
+    return Result;
+}
 
-        glTexCoord2f(1.0f, bat); glVertex2f(X+GfxFnt.Cols, Y2);
-        glTexCoord2f(1.0f, rat); glVertex2f(X+GfxFnt.Cols, Y1);
-        glTexCoord2f(0.0f, bat); glVertex2f(X, Y2);
+static void gfxViewClose(gfx_view* View)
+{
+    gfxViewFindEnd(View);
 
-        X += GfxFnt.Cols;
+    if(View->Index)
+    {
+        gfxAtomicStore(&View->Stop, 1);
+        gfxSemPost(&View->Wake, 1);
+        gfxThreadJoin(&View->Thread);
+        gfxSemFree(&View->Wake);
+        gfxArenaFree(&View->Arena);
     }
 
-    glEnd();
+    if(View->Data && View->Follow)
+    {
+        gfxVirtualRelease((void*) View->Data, GFX_VIEW_RESERVE);
+    }
+    else if(View->Data)
+    {
+        gfxUnmapFile((void*) View->Data, View->Size);
+    }
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+    if(View->Watching)
+    {
+        gfxWatchClose(&View->Watch);
+    }
 
-#if 0
-    glColor4f(1.0f, 0.0f, 0.0f, 1.0f);
-    glBegin(GL_LINE_LOOP);
-    glVertex2f(X1, Y1);
-    glVertex2f(X, Y1);
-    glVertex2f(X, Y2);
-    glVertex2f(X1, Y2);
-    glEnd();
-#endif
+    gfxGridFree(&View->Grid);
+    if(View->Grid.Cells)
+    {
+        gfxVirtualFree(View->Grid.Cells);
+    }
 
-    GfxPos[1] += GfxFnt.Rows + GfxSep;
+    memset(View, 0, sizeof(*View));
 }
 
-static void gfxString(const char* String)
+// NOTE: Lines known to exist, all of them once the index is done
+static u64 gfxViewLines(gfx_view* View)
 {
-    usz Length = strlen(String);
-    gfxText(String, Length);
+    if(gfxAtomicLoad(&View->Done))
+    {
+        View->Known = View->Lines;
+    }
+    else
+    {
+        View->Known = Max(View->Known, (u64)(gfxAtomicLoad(&View->Count) - 1) * GFX_VIEW_STEP + 1);
+    }
+
+    return View->Known;
 }
 
-static void gfxImage(gfx_img* Img)
+// NOTE: Called every frame while following. Bytes past the end of the known part are read while both
+// threads wait, then they index and search them. A shrunk, replaced or rewritten file is read from the start.
+static void gfxViewUpdate(gfx_view* View)
 {
-    f32 X = GfxPos[0];
-    f32 Y = GfxPos[1];
-
-    glColor3f(1.0f, 1.0f, 1.0f);
+    gfxRequestFrame(GFX_VIEW_POLL_MS);
 
-    glBindTexture(GL_TEXTURE_2D, Img->Texture);
+    if(!View->Watching)
+    {
+        View->Watching = gfxWatchOpen(&View->Watch, View->Name);
+    }
 
-    glBegin(GL_TRIANGLE_STRIP);
+    // NOTE: Without a watch the file is read at every frame
+    if(View->Watching && gfxWatchPoll(&View->Watch))
+    {
+        View->Changed = 1;
+    }
 
-    glTexCoord2f(0.0f, 1.0f); glVertex2f(X, Y);
-    glTexCoord2f(1.0f, 1.0f); glVertex2f(X+Img->Cols, Y);
-    glTexCoord2f(0.0f, 0.0f); glVertex2f(X, Y+Img->Rows);
-    glTexCoord2f(1.0f, 0.0f); glVertex2f(X+Img->Cols, Y+Img->Rows);
+    gfx_find* Find = &View->Find;
+    b32 Busy = View->Index && !gfxAtomicLoad(&View->Done);
+    Busy |= Find->Running && !gfxAtomicLoad(&Find->Done);
+    if(!View->Data || (View->Watching && !View->Changed) || Busy)
+    {
+        return;
+    }
 
-    glEnd();
+    View->Changed = 0;
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+    usz Size = Min(GFX_VIEW_READ, GFX_VIEW_RESERVE - View->Size);
+    if(View->Size + Size > View->Committed)
+    {
+        usz Commit = (View->Size + Size - View->Committed + GFX_ARENA_COMMIT - 1) & ~(usz)(GFX_ARENA_COMMIT - 1);
+        Commit = Min(Commit, GFX_VIEW_RESERVE - View->Committed);
+        Assert(gfxVirtualCommit((u8*) View->Data + View->Committed, Commit));
+        View->Committed += Commit;
+    }
 
-    GfxPos[1] += Img->Rows + GfxSep;
-}
+    gfx_stamp Stamp;
+    if(!gfxReadFileAt(View->Name, View->Size, (u8*) View->Data + View->Size, &Size, &Stamp))
+    {
+        // NOTE: Removed, a watch of it would stay quiet when it comes back
+        if(View->Watching)
+        {
+            gfxWatchClose(&View->Watch);
+            View->Watching = 0;
+        }
 
-void gfxPolygon(f32 CX, f32 CY, f32 R, u32 N)
-{
-    glBegin(GL_POLYGON);
+        return;
+    }
 
-    for(u32 Idx = 0; Idx < N; Idx++)
+    gfx_stamp* Known = &View->Stamp;
+    b32 Same = (Stamp.Dev == Known->Dev && Stamp.Ino == Known->Ino && Stamp.Size >= View->Size);
+    Same &= (Stamp.Size != View->Size || Stamp.Time == Known->Time);
+    if(Same || !View->Size)
     {
-        f32 Theta = 2.0f * PI_F32 * Idx / N;
-        f32 X = R * cosf(Theta);
-        f32 Y = R * sinf(Theta);
-        glVertex2f(X + CX, Y + CY);
+        View->Stamp = Stamp;
+        if(Size)
+        {
+            View->Size += Size;
+            View->Stale = 1;
+            gfxAtomicStore(&View->Done, 0);
+            gfxSemPost(&View->Wake, 1);
+            if(Find->Running)
+            {
+                gfxAtomicStore(&Find->Done, 0);
+                gfxSemPost(&Find->Wake, 1);
+            }
+        }
+
+        // NOTE: The rest is read in the next frames, once both threads are done
+        View->Changed = (View->Size < Stamp.Size && View->Size < GFX_VIEW_RESERVE);
+        return;
     }
 
-    glEnd();
+    const char* Name = View->Name;
+    char Text[GFX_FIND_MAX];
+    u32 Length = Find->Size;
+    memcpy(Text, Find->Text, Length);
+
+    gfxViewClose(View);
+    gfxViewFollow(View, Name);
+    gfxViewFind(View, Text, Length);
 }
 
-static void gfxColorRGB8(u8 R, u8 G, u8 B)
+// NOTE: Offset of the start of a line, scanned from the checkpoint before it, Size when there is no such line
+static usz gfxViewSeek(gfx_view* View, u64 Line)
 {
-    glColor3f(R / 255.F, G / 255.F, B / 255.F);
+    u64 Checkpoint = Min(Line / GFX_VIEW_STEP, (u64)gfxAtomicLoad(&View->Count) - 1);
+    usz Offset = View->Index[Checkpoint];
+
+    u32 Left = (u32) Min(Line - Checkpoint * GFX_VIEW_STEP, (u64)0xFFFFFFFF);
+    Offset += gfxScanLines(View->Data + Offset, View->Size - Offset, &Left);
+    return Left ? View->Size : Offset;
 }
 
-static b32 gfxPointInRect(v2f Pt, v2f TL, v2f BR)
+// NOTE: First of Count hits at or after Offset
+static u32 gfxFindHit(const u64* Hits, u32 Count, u64 Offset)
 {
-    if(Pt[0] >= TL[0] && Pt[0] <= BR[0] &&
-       Pt[1] >= TL[1] && Pt[1] <= BR[1])
-    {
-        return 1;
-    }
-    else
+    u32 Lo = 0;
+    u32 Hi = Count;
+    while(Lo < Hi)
     {
-        return 0;
+        u32 Mid = Lo + (Hi - Lo) / 2;
+        if(Hits[Mid] < Offset)
+        {
+            Lo = Mid + 1;
+        }
+        else
+        {
+            Hi = Mid;
+        }
     }
+
+    return Lo;
 }
 
-static void gfxRect(f32 X1, f32 Y1, f32 X2, f32 Y2)
+// NOTE: Line of the byte at Offset, counted from the checkpoint before it
+static u64 gfxViewLineAt(gfx_view* View, usz Offset)
 {
-    glBegin(GL_TRIANGLE_STRIP);
+    u32 Checkpoint = gfxFindHit(View->Index, gfxAtomicLoad(&View->Count), (u64)Offset + 1) - 1;
+    usz Begin = View->Index[Checkpoint];
 
-    glVertex2f(X1, Y1);
-    glVertex2f(X2, Y1);
-    glVertex2f(X1, Y2);
-    glVertex2f(X2, Y2);
-
-    glEnd();
+    u32 Left = 0xFFFFFFFF;
+    gfxScanLines(View->Data + Begin, Offset - Begin, &Left);
+    return (u64)Checkpoint * GFX_VIEW_STEP + (0xFFFFFFFF - Left);
 }
 
-typedef enum
+// NOTE: Moves the first drawn line to the next hit below it, or to the previous one above it when Dir is
+// negative. Only hits up to the last checkpoint of the index are looked at, so the line of a hit is found by
+// scanning at most GFX_VIEW_STEP lines and lies within the lines known to the view.
+static b32 gfxViewJump(gfx_view* View, i32 Dir)
 {
-    GFX_ITEM_IDLE,
-    GFX_ITEM_HOVER,
-    GFX_ITEM_ACTIVE,
-    GFX_ITEM_RELEASE,
-} gfx_its;
+    b32 Result = 0;
 
-static int gfxProcessItem(const void* Item, v2f TL, v2f BR)
-{
-    if(gfxPointInRect(GfxCur, TL, BR))
+    gfx_find* Find = &View->Find;
+    u32 Count = gfxAtomicLoad(&Find->Count);
+    if(View->Data && Count)
     {
-        if(GfxBtn)
+        u64 Indexed = View->Size;
+        if(!gfxAtomicLoad(&View->Done))
         {
-            if(GfxHot == 0 || GfxHot == Item)
-            {
-                GfxHot = Item;
+            Indexed = View->Index[gfxAtomicLoad(&View->Count) - 1];
+        }
 
-                return GFX_ITEM_ACTIVE;
-            }
-            else
+        Count = gfxFindHit(Find->Hits, Count, Indexed + 1);
+    }
+
+    if(View->Data && Count)
+    {
+        u64 Line = View->First;
+        if(Dir >= 0)
+        {
+            u32 Hit = gfxFindHit(Find->Hits, Count, gfxViewSeek(View, Line + 1));
+            if(Hit < Count)
             {
-                return GFX_ITEM_IDLE;
+                View->First = gfxViewLineAt(View, Find->Hits[Hit]);
+                Result = 1;
             }
         }
         else
         {
-            if(GfxHot == Item)
-            {
-                return GFX_ITEM_RELEASE;
-            }
-            else
+            u32 Hit = gfxFindHit(Find->Hits, Count, gfxViewSeek(View, Line));
+            if(Hit)
             {
-                return GFX_ITEM_HOVER;
+                View->First = gfxViewLineAt(View, Find->Hits[Hit - 1]);
+                Result = 1;
             }
         }
+
+        View->Tail &= !Result;
     }
-    else
-    {
-        return GFX_ITEM_IDLE;
-    }
+
+    return Result;
 }
 
-static b32 gfxButton(const char* Text)
+// NOTE: Tabs are expanded, carriage returns dropped and the rest of the row is blanked. Hits of the search
+// among the first Marked get a background, Begin is the offset of the text in the file.
+static void gfxViewRow(gfx_view* View, u32 Row, usz Begin, usz Size, u32 Fg)
 {
-    b32 Result = 0;
+    static const char Blank[] = "        "; // GFX_VIEW_TAB spaces
 
-    usz Len = strlen(Text);
+    gfx_grid* Grid = &View->Grid;
+    const char* Text = View->Data + Begin;
 
-    v2f TL, BR;
-    TL[0] = GfxPos[0];
-    TL[1] = GfxPos[1];
-    BR[0] = GfxPos[0] + (Len + 1) * GfxFnt.Cols;
-    BR[1] = GfxPos[1] + GfxFnt.Rows;
+    const u64* Hits = View->Find.Hits;
+    u32 Count = View->Marked;
+    u32 Hit = gfxFindHit(Hits, Count, Begin);
+    usz Mark = 0; // End of the hits at or before Idx
 
-    switch(gfxProcessItem(Text, TL, BR))
+    u32 Col = 0;
+    for(usz Idx = 0; Idx < Size && Col < Grid->Cols;)
     {
-        case GFX_ITEM_IDLE:   gfxColorRGB8(44, 74, 114);  break;
-        case GFX_ITEM_ACTIVE: gfxColorRGB8(15, 135, 250); break;
-        case GFX_ITEM_RELEASE:  Result = 1; // fallthrough
-        case GFX_ITEM_HOVER:  gfxColorRGB8(66, 150, 250); break;
-    }
-
-    gfxRect(TL[0], TL[1], BR[0], BR[1]);
+        while(Hit < Count && Hits[Hit] - Begin <= Idx)
+        {
+            Mark = Max(Mark, (usz)(Hits[Hit] - Begin) + View->Find.Size);
+            Hit++;
+        }
 
-    GfxPos[0] += GfxFnt.Cols/2;
+        // NOTE: Runs of text end where a hit starts or ends
+        u32 Bg = (Idx < Mark) ? GFX_VIEW_HIT : 0;
+        usz Stop = (Idx < Mark) ? Mark : (Hit < Count) ? (usz)(Hits[Hit] - Begin) : Size;
+        Stop = Min(Stop, Size);
 
-    glColor3f(1.0f, 1.0f, 1.0f);
-    gfxString(Text);
+        if(Text[Idx] == '\t')
+        {
+            Col = gfxGridText(Grid, Col, Row, Blank, GFX_VIEW_TAB - Col % GFX_VIEW_TAB, Fg, Bg);
+            Idx++;
+        }
+        else if(Text[Idx] == '\r')
+        {
+            Idx++;
+        }
+        else
+        {
+            usz End = Idx;
+            while(End < Stop && Text[End] != '\t' && Text[End] != '\r')
+            {
+                End++;
+            }
 
-    GfxPos[0] -= GfxFnt.Cols/2;
+            Col = gfxGridText(Grid, Col, Row, Text + Idx, End - Idx, Fg, Bg);
+            Idx = End;
+        }
+    }
 
-    return Result;
+    while(Col < Grid->Cols)
+    {
+        Col = gfxGridText(Grid, Col, Row, Blank, Min(Grid->Cols - Col, GFX_VIEW_TAB), Fg, 0);
+    }
 }
 
-static b32 gfxRadioButton(const char* Text, i32* Value, i32 Target)
+// NOTE: Scrolls with the wheel while hovered, with up and down keys after a click, and with the bar on the
+// right. Only the lines in the view are read, and only when they change.
+static void gfxTextView(gfx_view* View, u32 Cols, u32 Rows)
 {
-    b32 Result = 0;
-
-    usz Len = strlen(Text);
+    GFX_TRACE_BEGIN("gfxTextView");
 
-    v2f TL, BR;
-    TL[0] = GfxPos[0];
-    TL[1] = GfxPos[1];
-    BR[0] = GfxPos[0] + GfxFnt.Rows + (Len + 0.5f) * GfxFnt.Cols;
-    BR[1] = GfxPos[1] + GfxFnt.Rows;
-
-    f32 R = GfxFnt.Rows * 0.5f;
+    f32 X1 = GfxPos[0];
+    f32 Y1 = GfxPos[1];
+    f32 X2 = X1 + (Cols + 1) * GfxFnt.Cols;
+    f32 Y2 = Y1 + Rows * GfxFnt.Rows;
+    f32 Bar = X2 - GfxFnt.Cols;
 
-    switch(gfxProcessItem(Text, TL, BR))
+    if(View->Follow)
     {
-        case GFX_ITEM_IDLE:   gfxColorRGB8(33, 51, 77);  break;
-        case GFX_ITEM_ACTIVE: gfxColorRGB8(51, 107, 174); break;
-        case GFX_ITEM_RELEASE:  *Value = Target; Result = 1; // fallthrough
-        case GFX_ITEM_HOVER:  gfxColorRGB8(40, 74, 114); break;
+        gfxViewUpdate(View);
     }
 
-    gfxPolygon(GfxPos[0] + R, GfxPos[1] + R, R, 10);
-
-    if(*Value == Target)
+    if(!View->Data || !Cols || !Rows || !gfxVisible(X1, Y1, X2, Y2))
     {
-        gfxColorRGB8(66, 150, 250);
-
-        gfxPolygon(GfxPos[0] + R, GfxPos[1] + R, R*0.6f, 10);
+        GfxPos[1] = Y2 + GfxSep;
+        GFX_TRACE_END("gfxTextView");
+        return;
     }
 
-    GfxPos[0] += GfxFnt.Rows + GfxFnt.Cols/2;
-
-    glColor3f(1.0f, 1.0f, 1.0f);
-
-    gfxString(Text);
-
-    GfxPos[0] -= GfxFnt.Rows + GfxFnt.Cols/2;
-
-    return Result;
-}
+    gfx_find* Find = &View->Find;
+    if(!gfxAtomicLoad(&View->Done) || (Find->Running && !gfxAtomicLoad(&Find->Done)))
+    {
+        gfxRequestFrame(0);
+    }
 
-static void gfxCheckmark(f32 X, f32 Y, f32 M)
-{
-    // TODO: SIMD
-    f32 Ax = X + 0.15f * M, Ay = Y + 0.40f * M;
-    f32 Bx = X + 0.45f * M, By = Y + 0.80f * M;
-    f32 Cx = X + 0.80f * M, Cy = Y + 0.20f * M;
-    f32 Dx = X + 0.40f * M, Dy = Y + 0.55f * M;
+    // NOTE: Hits come in file order, so new ones land in the grid only when they start before its end and
+    // end after its start
+    u32 Marked = gfxAtomicLoad(&Find->Count);
+    if(Marked != View->Marked)
+    {
+        if(Find->Hits[View->Marked] < View->GridEnd && Find->Hits[Marked - 1] + Find->Size > View->GridBegin)
+        {
+            View->Stale = 1;
+        }
 
-    glBegin(GL_TRIANGLES);
+        View->Marked = Marked;
+    }
 
-    glVertex2f(Ax, Ay);
-    glVertex2f(Bx, By);
-    glVertex2f(Dx, Dy);
+    u64 Lines = gfxViewLines(View);
+    u64 Last = (Lines > Rows) ? Lines - Rows : 0;
+    if(View->Follow && View->Tail)
+    {
+        View->First = Last;
+    }
 
-    glVertex2f(Dx, Dy);
-    glVertex2f(Bx, By);
-    glVertex2f(Cx, Cy);
+    v2f TL, BR;
+    TL[0] = X1;
+    TL[1] = Y1;
+    BR[0] = Bar;
+    BR[1] = Y2;
+
+    gfx_id Id = gfxIdPtr(View);
+    i64 Delta = 0;
+    if(gfxProcessItem(Id, TL, BR) != GFX_ITEM_IDLE)
+    {
+        Delta -= 3 * GfxWheel;
+    }
 
-    glEnd();
-}
+    if(GfxPrevHot == Id)
+    {
+        i64 Step = GfxKeyShift ? Rows : 1;
+        Delta += Step * ((i64)GfxKeyDown - (i64)GfxKeyUp);
+    }
 
-static b32 gfxCheckBox(const char* Text, b32* Value)
-{
-    b32 Result = 0;
+    if(Delta < 0)
+    {
+        View->First = ((u64)-Delta < View->First) ? View->First - (u64)-Delta : 0;
+    }
+    else
+    {
+        View->First += (u64)Delta;
+    }
 
-    usz Len = strlen(Text);
+    TL[0] = Bar;
+    BR[0] = X2;
 
-    v2f TL, BR, MR;
+    gfx_id BarId = gfxIdPtr(&View->First);
+    u32 BarState = gfxProcessItem(BarId, TL, BR);
+    f32 Thumb = Max((f32)GfxFnt.Rows, (Y2 - Y1) * Rows / (f32)(Last + Rows));
+    if(GfxHot == BarId)
+    {
+        f32 Pos = (GfxCur[1] - GfxState.Offset[1] - Y1 - Thumb * 0.5f) / (Y2 - Y1 - Thumb);
+        View->First = (u64) (Clamp(0.0f, 1.0f, Pos) * (f64)Last + 0.5);
+    }
 
-    TL[0] = GfxPos[0];
-    TL[1] = GfxPos[1];
+    // NOTE: Scrolling down to the last line starts following again, any other scrolling stops it
+    View->First = Min(View->First, Last);
+    if(Delta || GfxHot == BarId)
+    {
+        View->Tail = (View->First == Last);
+    }
 
-    MR[0] = GfxPos[0] + GfxFnt.Rows;
-    MR[1] = GfxPos[1] + GfxFnt.Rows;
+    gfx_grid* Grid = &View->Grid;
+    if(Grid->Cols != Cols || Grid->Rows != Rows)
+    {
+        gfxGridFree(Grid);
+        if(Grid->Cells)
+        {
+            gfxVirtualFree(Grid->Cells);
+        }
 
-    BR[0] = MR[0] + (Len + 0.5f) * GfxFnt.Cols;
-    BR[1] = MR[1];
+        memset(Grid, 0, sizeof(*Grid));
+        Grid->Cols = Cols;
+        Grid->Rows = Rows;
+        Assert(Grid->Cells = gfxVirtualAlloc((usz)Cols * Rows * sizeof(gfx_cell)));
+        gfxGridScroll(Grid, Rows);
+        View->Shown = ~(u64)0;
+    }
 
-    switch(gfxProcessItem(Text, TL, BR))
+    if(View->Shown != View->First || View->Stale)
     {
-        case GFX_ITEM_IDLE:   gfxColorRGB8(33, 51, 77);  break;
-        case GFX_ITEM_ACTIVE: gfxColorRGB8(51, 107, 174); break;
-        case GFX_ITEM_RELEASE:  *Value = !*Value; Result = 1; // fallthrough
-        case GFX_ITEM_HOVER:  gfxColorRGB8(40, 74, 114); break;
-    }
+        // NOTE: Rows still in the view move with the ring, so only the new ones change
+        if(View->Shown != ~(u64)0 && View->Shown != View->First)
+        {
+            i64 Moved = (i64)(View->First - View->Shown);
+            if(Moved > -(i64)Rows && Moved < (i64)Rows)
+            {
+                gfxGridScroll(Grid, (i32)Moved);
+            }
+        }
 
-    gfxRect(TL[0], TL[1], MR[0], MR[1]);
+        usz Offset = gfxViewSeek(View, View->First);
+        View->GridBegin = Offset;
+        for(u32 Row = 0; Row < Rows; Row++)
+        {
+            u32 Left = 1;
+            usz Begin = Offset;
+            Offset += gfxScanLines(View->Data + Offset, View->Size - Offset, &Left);
 
-    if(*Value)
-    {
-        gfxColorRGB8(66, 150, 250);
+            // NOTE: A column takes at most 4 bytes, the rest of a long line is not looked at
+            usz End = Offset - !Left;
+            gfxViewRow(View, Row, Begin, Min(End - Begin, (usz)Cols * 4), GfxColor);
+        }
 
-#if 0
-        gfxRect(TL[0] + 0.20f * GfxFnt.Rows, TL[1] + 0.20f * GfxFnt.Rows,
-                TL[0] + 0.80f * GfxFnt.Rows, TL[1] + 0.80f * GfxFnt.Rows);
-#else
-        gfxCheckmark(TL[0], TL[1], (f32)GfxFnt.Rows);
-#endif
+        View->GridEnd = Offset;
+        View->Shown = View->First;
+        View->Stale = 0;
     }
 
-    GfxPos[0] += GfxFnt.Rows + GfxFnt.Cols/2;
+    u32 Color = GfxColor;
+    gfxColorRGB8(32, 34, 36);
+    gfxRect(X1, Y1, Bar, Y2);
 
-    glColor3f(1.0f, 1.0f, 1.0f);
+    GfxPos[0] = X1;
+    GfxPos[1] = Y1;
+    gfxGrid(Grid);
 
-    gfxString(Text);
+    gfxColorRGB8(64, 68, 71);
+    gfxRect(Bar, Y1, X2, Y2);
 
-    GfxPos[0] -= GfxFnt.Rows + GfxFnt.Cols/2;
+    switch(BarState)
+    {
+        case GFX_ITEM_IDLE:    gfxColor4f(0.5f, 0.5f, 0.5f, 0.5f); break;
+        case GFX_ITEM_ACTIVE:  gfxColor4f(0.8f, 0.8f, 0.8f, 0.8f); break;
+        case GFX_ITEM_RELEASE: // fallthrough
+        case GFX_ITEM_HOVER:   gfxColor4f(0.7f, 0.7f, 0.7f, 0.7f); break;
+    }
 
-    return Result;
+    f32 ThumbY = Y1 + (Last ? (f32)((f64)View->First / Last) : 0.0f) * (Y2 - Y1 - Thumb);
+    gfxRect(Bar, ThumbY, X2, ThumbY + Thumb);
+
+    GfxColor = Color;
+    GfxPos[0] = X1;
+    GfxPos[1] = Y2 + GfxSep;
+
+    GFX_TRACE_END("gfxTextView");
 }
 
-static usz gfxFormatV(char* Buffer, usz Length, const char* Format, va_list Args)
+static void gfxClear(f32 R, f32 G, f32 B)
 {
-    int Ret = vsnprintf(Buffer, Length, Format, Args);
-    if(Ret < 0)
-    {
-        Ret = 0;
-    }
-
-    usz Count = (usz) Ret;
-    if(Count >= Length)
+    if(GfxBackend == GFX_BACKEND_SOFT)
     {
-        Count = (int)Length-1;
+        gfxSoftClear(gfxPackColor(R, G, B, 0.0f));
+        return;
     }
 
-    Buffer[Count] = 0;
-    return (usz)Count;
+#if GFX_GL
+    glViewport(0, 0, (i32)GfxCols, (i32)GfxRows);
+    glClearColor(R, G, B, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
+#endif
 }
 
-static usz gfxFormat(char* Buffer, usz Length, const char* Format, ...)
+static void gfxBegin(void)
 {
-    usz Result;
-
-    va_list Args;
-    va_start(Args, Format);
-    Result = gfxFormatV(Buffer, Length, Format, Args);
-    va_end(Args);
+    GfxPos[0] = GfxSep;
+    GfxPos[1] = GfxSep;
 
-    return Result;
+    // NOTE: Every push must have been popped by now
+    Assert(GfxStackCount == 0);
+    Assert(GfxIdCount == 0);
+    GfxState.Clip[0] = 0;
+    GfxState.Clip[1] = 0;
+    GfxState.Clip[2] = (i32)GfxCols;
+    GfxState.Clip[3] = (i32)GfxRows;
+    GfxState.Offset[0] = 0.0f;
+    GfxState.Offset[1] = 0.0f;
 }
 
-static b32 gfxSliderFloat(f32 A, f32 B, f32* V, const char* Text)
+static void gfxEnd(void)
 {
-    b32 Result = 0;
-
-    v2f STL, SBR;
-    STL[0] = GfxPos[0];
-    STL[1] = GfxPos[1];
-    SBR[0] = STL[0] + 300;
-    SBR[1] = STL[1] + GfxFnt.Rows;
+    gfxFlush();
+}
 
-    if(GfxPrevHot == V)
+// NOTE: Called once at the end of the frame, after all gfxBegin and gfxEnd pairs
+static void gfxEndFrame(void)
+{
+    GfxLayer = 1;
+    for(GfxTarget = &GfxPopupDraw; GfxTarget; GfxTarget = GfxTarget->Next)
     {
-        f32 Mult = GfxKeyShift ? 10.0f : 100.0f;
-        f32 Speed = (B - A) / Mult;
+        gfxFlush();
+    }
+    GfxPopupDraw.Next = 0;
+    GfxLayer = 0;
+    GfxTarget = &GfxDraw;
 
-        if(GfxKeyLeft) *V = Max(*V - Speed, A);
-        if(GfxKeyRight) *V = Min(*V + Speed, B);
+    // NOTE: Only the work of the frame is timed, waiting for input and for the swap comes after
+    GfxFrameMs[GfxFrame % GFX_STATS_FRAMES] = (gfxClock() - GfxFrameStart) / 1000000.0f;
 
-        Result = 1;
-    }
+    gfxHitSwap();
+
+    GfxFrameArena = &GfxFrameArenas[GfxFrameArena == &GfxFrameArenas[0]];
+    gfxArenaReset(GfxFrameArena);
 
-    if(GfxHot == V)
+    if(!GfxBtn)
     {
-        glColor4f(0.8f, 0.8f, 0.8f, 0.8f);
+        if(GfxHot)
+        {
+            GfxPrevHot = GfxHot;
+        }
 
-        f32 Value = A + (GfxCur[0] - STL[0]) * (B - A) / (SBR[0] - STL[0]);
+        GfxHot = 0;
+    }
+}
 
-        *V = Clamp(A, B, Value);
+//
+// RECORDING
+//
 
-        Result = 1;
-    }
+#define GFX_REC_MAGIC 0x31524647 // "GFR1"
+#define GFX_REC_VERSION 4
 
-    gfxColorRGB8(64, 68, 71);
-    gfxRect(STL[0], STL[1], SBR[0], SBR[1]);
+typedef struct
+{
+    u32 Magic;
+    u32 Version;
+    u32 Frames;
+    u32 Count; // Number of gfx_input records
+} gfx_rec_hdr;
 
-    char Buffer[128];
-    usz Length = gfxFormat(Buffer, sizeof(Buffer), Text, *V);
+// NOTE: Input state of a frame, Repeat consecutive identical frames share one record
+typedef struct
+{
+    i16 CurX;
+    i16 CurY;
+    u16 Cols;
+    u16 Rows;
+    u8 Btn;
+    u8 KeyLeft;
+    u8 KeyRight;
+    u8 KeyUp;
+    u8 KeyDown;
+    u8 KeyShift;
+    i8 Wheel;
+    u16 Repeat;
+    u32 TimeUs; // Frame clock time of all Repeat frames, spread evenly over them on replay
+} gfx_input;
 
-    GfxPos[0] = (SBR[0] + STL[0] - Length * GfxFnt.Cols) * 0.5f;
-    glColor3f(1.0f, 1.0f, 1.0f);
-    gfxText(Buffer, Length);
-    GfxPos[0] = STL[0];
+typedef struct
+{
+    FILE* File;
+    gfx_rec_hdr Hdr;
+    gfx_input Last;
+} gfx_rec;
 
-    f32 Width = 25.0f;
-    f32 Offset = (SBR[0] - STL[0] - Width) * (*V - A) / (B - A);
+typedef struct
+{
+    void* Data;
+    gfx_rec_hdr* Hdr;
+    gfx_input* Inputs;
+    u32 Next;
+    u32 Repeat;
+} gfx_play;
+
+static void gfxInputCapture(gfx_input* Input)
+{
+    // NOTE: Records are compared with memcmp, padding included
+    memset(Input, 0, sizeof(*Input));
+    Input->CurX = (i16) Clamp(-0x8000, 0x7FFF, (i32)GfxCur[0]);
+    Input->CurY = (i16) Clamp(-0x8000, 0x7FFF, (i32)GfxCur[1]);
+    Input->Cols = (u16) Clamp(0, 0xFFFF, (i32)GfxCols);
+    Input->Rows = (u16) Clamp(0, 0xFFFF, (i32)GfxRows);
+    Input->Btn = (u8) (GfxBtn != 0);
+    Input->KeyLeft = GfxKeyLeft;
+    Input->KeyRight = GfxKeyRight;
+    Input->KeyUp = GfxKeyUp;
+    Input->KeyDown = GfxKeyDown;
+    Input->KeyShift = GfxKeyShift;
+    Input->Wheel = GfxWheel;
+    Input->Repeat = 1;
+    Input->TimeUs = (u32) (GfxDelta * 1000000.0f + 0.5f);
+}
 
-    v2f BTL, BBR;
-    BTL[0] = STL[0] + Offset;
-    BTL[1] = STL[1];
-    BBR[0] = BTL[0] + Width;
-    BBR[1] = SBR[1];
+// NOTE: Frame is the index of the applied frame among the Repeat ones of the record
+static void gfxInputApply(const gfx_input* Input, u32 Frame)
+{
+    GfxCur[0] = Input->CurX;
+    GfxCur[1] = Input->CurY;
+    GfxCols = Input->Cols;
+    GfxRows = Input->Rows;
+    GfxBtn = Input->Btn;
+    GfxKeyLeft = Input->KeyLeft;
+    GfxKeyRight = Input->KeyRight;
+    GfxKeyUp = Input->KeyUp;
+    GfxKeyDown = Input->KeyDown;
+    GfxKeyShift = Input->KeyShift;
+    GfxWheel = Input->Wheel;
+
+    // NOTE: Times of all frames of the run add up to the recorded one
+    u64 Begin = (u64)Input->TimeUs * Frame / Input->Repeat;
+    u64 End = (u64)Input->TimeUs * (Frame + 1) / Input->Repeat;
+    gfxStepFrame((End - Begin) / 1000000.0f);
+}
+
+static b32 gfxRecOpen(gfx_rec* Rec, const char* Path)
+{
+    b32 Result = 0;
 
-    switch(gfxProcessItem(V, BTL, BBR))
+    memset(Rec, 0, sizeof(*Rec));
+    Rec->Hdr.Magic = GFX_REC_MAGIC;
+    Rec->Hdr.Version = GFX_REC_VERSION;
+    Rec->File = fopen(Path, "wb");
+    if(Rec->File)
     {
-        case GFX_ITEM_IDLE:    glColor4f(0.5f, 0.5f, 0.5f, 0.5f); break;
-        case GFX_ITEM_ACTIVE:  glColor4f(0.8f, 0.8f, 0.8f, 0.8f); break;
-        case GFX_ITEM_RELEASE: // fallthrough
-        case GFX_ITEM_HOVER:   glColor4f(0.7f, 0.7f, 0.7f, 0.7f); break;
+        if(fwrite(&Rec->Hdr, sizeof(Rec->Hdr), 1, Rec->File) == 1)
+        {
+            Result = 1;
+        }
+        else
+        {
+            fclose(Rec->File);
+            Rec->File = 0;
+        }
     }
 
-    gfxRect(BTL[0], BTL[1], BBR[0], BBR[1]);
-
     return Result;
 }
 
-static b32 gfxGroupBox(const char* Title)
+// NOTE: Call once per frame, after input is gathered and gfxNewFrame, before AppUpdate
+static void gfxRecFrame(gfx_rec* Rec)
 {
-    b32 Result = 0;
+    gfx_input Input;
+    gfxInputCapture(&Input);
 
-    f32 X1 = GfxPos[0];
-    f32 Y1 = GfxPos[1] + GfxFnt.Rows/2;
-    f32 X2 = X1 + 400.0f;
-    f32 Y2 = Y1 + 200.0f;
+    gfx_input* Last = &Rec->Last;
+    if(Rec->Hdr.Frames)
+    {
+        // NOTE: Frame deltas jitter, so they are summed over a run instead of compared
+        u32 TimeUs = Input.TimeUs;
+        Input.Repeat = Last->Repeat;
+        Input.TimeUs = Last->TimeUs;
+        if(memcmp(&Input, Last, sizeof(Input)) == 0 && Last->Repeat < 0xFFFF && Last->TimeUs <= 0xFFFFFFFF - TimeUs)
+        {
+            Last->Repeat++;
+            Last->TimeUs += TimeUs;
+            Rec->Hdr.Frames++;
+            return;
+        }
 
-    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+        fwrite(Last, sizeof(*Last), 1, Rec->File);
+        Rec->Hdr.Count++;
+        Input.Repeat = 1;
+        Input.TimeUs = TimeUs;
+    }
+
+    *Last = Input;
+    Rec->Hdr.Frames++;
+}
 
-    glBegin(GL_LINE_LOOP);
+static b32 gfxRecClose(gfx_rec* Rec)
+{
+    b32 Result = 0;
 
-    glVertex2f(X1, Y1);
-    glVertex2f(X2, Y1);
-    glVertex2f(X2, Y2);
-    glVertex2f(X1, Y2);
+    if(Rec->File)
+    {
+        if(Rec->Hdr.Frames)
+        {
+            fwrite(&Rec->Last, sizeof(Rec->Last), 1, Rec->File);
+            Rec->Hdr.Count++;
+        }
 
-    glEnd();
+        if(fseek(Rec->File, 0, SEEK_SET) == 0 &&
+           fwrite(&Rec->Hdr, sizeof(Rec->Hdr), 1, Rec->File) == 1 &&
+           !ferror(Rec->File))
+        {
+            Result = 1;
+        }
 
-    GfxPos[0] += GfxSep / 2;
-    gfxString(Title);
-    GfxPos[0] += GfxSep / 2; // IMPORTANT
+        fclose(Rec->File);
+        Rec->File = 0;
+    }
 
     return Result;
 }
 
-static b32 gfxProgressBar(f32 Left, f32 Right, f32* V, const char* Fmt)
+static b32 gfxPlayOpen(gfx_play* Play, const char* Path)
 {
     b32 Result = 0;
 
-    f32 X1 = GfxPos[0];
-    f32 Y1 = GfxPos[1];
-    f32 X2 = X1 + 200;
-    f32 Y2 = Y1 + GfxFnt.Rows;
-
-    f32 XM = X1 + (X2 - X1) * (*V - Left) / (Right - Left);
-
-    glColor3f(32/255.f, 50/255.f, 77/255.f);
-    gfxRect(X1, Y1, X2, Y2);
-
-    glColor3f(61/255.f, 132/255.f, 221/255.f);
-    gfxRect(X1+1, Y1+1, XM-1, Y2-1);
+    memset(Play, 0, sizeof(*Play));
 
-    if(!Fmt)
+    usz Size = 0;
+    u8* Data = gfxLoadFile(Path, &Size);
+    if(Data)
     {
-        Fmt = "%.1lf";
+        gfx_rec_hdr* Hdr = (gfx_rec_hdr*) Data;
+        if(Size >= sizeof(*Hdr) &&
+           Hdr->Magic == GFX_REC_MAGIC &&
+           Hdr->Version == GFX_REC_VERSION &&
+           Size == sizeof(*Hdr) + (usz)Hdr->Count * sizeof(gfx_input))
+        {
+            Play->Data = Data;
+            Play->Hdr = Hdr;
+            Play->Inputs = (gfx_input*) (Hdr + 1);
+            Result = 1;
+        }
+        else
+        {
+            // TODO: Logging
+            gfxVirtualFree(Data);
+        }
+    }
+    else
+    {
+        // TODO: Logging
     }
-
-    glColor3f(1.f, 1.f, 1.f);
-
-    char Buffer[128];
-    usz Length = gfxFormat(Buffer, sizeof(Buffer), Fmt, *V);
-    GfxPos[0] = (X2 + X1 - Length * GfxFnt.Cols) / 2.f;
-    gfxText(Buffer, Length);
-    GfxPos[0] = X1;
 
     return Result;
 }
 
-static b32 gfxComboBox(const char** Choice, const char** Array, usz Count)
+// NOTE: Applies the input of the next recorded frame, returns 0 at the end of the log
+static b32 gfxPlayFrame(gfx_play* Play)
 {
-    b32 Result = 0;
-
-    v2f TL, BR;
-    TL[0] = GfxPos[0];
-    TL[1] = GfxPos[1];
-    BR[0] = GfxPos[0] + 300;
-    BR[1] = GfxPos[1] + GfxFnt.Rows;
-    switch(gfxProcessItem(Choice, TL, BR))
+    while(Play->Next < Play->Hdr->Count)
     {
-        case GFX_ITEM_IDLE:   gfxColorRGB8(44, 74, 114);  break;
-        case GFX_ITEM_ACTIVE: gfxColorRGB8(15, 135, 250); break;
-        case GFX_ITEM_RELEASE:  Result = 1; // fallthrough
-        case GFX_ITEM_HOVER:  gfxColorRGB8(66, 150, 250); break;
+        gfx_input* Input = &Play->Inputs[Play->Next];
+        if(Play->Repeat < Input->Repeat)
+        {
+            gfxInputApply(Input, Play->Repeat++);
+            return 1;
+        }
+
+        Play->Next++;
+        Play->Repeat = 0;
     }
 
-    gfxRect(TL[0], TL[1], BR[0], BR[1]);
-    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
-    glBegin(GL_TRIANGLES);
-        glVertex2f(BR[0] - 1.5f * GfxFnt.Cols, TL[1] + GfxFnt.Rows * 0.25f);
-        glVertex2f(BR[0] - 0.5f * GfxFnt.Cols, TL[1] + GfxFnt.Rows * 0.25f);
-        glVertex2f(BR[0] - 1.0f * GfxFnt.Cols, BR[1] - GfxFnt.Rows * 0.25f);
-    glEnd();
+    return 0;
+}
 
-    GfxPos[0] += GfxFnt.Cols/2;
-    gfxString(*Choice);
-    GfxPos[0] -= GfxFnt.Cols/2;
+static void gfxPlayClose(gfx_play* Play)
+{
+    if(Play->Data)
+    {
+        gfxVirtualFree(Play->Data);
+    }
 
-    return Result;
+    memset(Play, 0, sizeof(*Play));
 }
 
-static void gfxBegin(void)
+static int gfxTimeCompare(const void* A, const void* B)
 {
-    GfxPos[0] = GfxSep;
-    GfxPos[1] = GfxSep;
+    u64 X = *(const u64*)A;
+    u64 Y = *(const u64*)B;
+    return (X > Y) - (X < Y);
 }
 
-static void gfxEnd(void)
+// NOTE: Prints mean and percentiles of frame times in nanoseconds, sorts Times in place
+static void gfxTimeReport(u64* Times, u32 Count)
 {
-    glBindTexture(GL_TEXTURE_2D, 0);
+    if(!Count)
+    {
+        return;
+    }
+
+    u64 Total = 0;
+    for(u32 Idx = 0; Idx < Count; Idx++)
+    {
+        Total += Times[Idx];
+    }
+
+    qsort(Times, Count, sizeof(u64), gfxTimeCompare);
+
+    static const u32 Percentiles[] = {50, 90, 95, 99};
+    gfxDebug("%u frames, mean %.3f ms", Count, Total / (1000000.0 * Count));
+    for(u32 Idx = 0; Idx < ArrLen(Percentiles); Idx++)
+    {
+        u64 Time = Times[(u64)(Count - 1) * Percentiles[Idx] / 100];
+        gfxDebug(", p%u %.3f ms", Percentiles[Idx], Time / 1000000.0);
+    }
+    gfxDebug(", max %.3f ms\n", Times[Count-1] / 1000000.0);
 }
 
-static b32 gfxInit(void)
+static b32 gfxInit(gfx_backend Backend)
 {
     b32 Result = 1;
 
-    Assert(glDebugMessageCallback = (PFNGLDEBUGMESSAGECALLBACKPROC) gfxGlGetProcAddress("glDebugMessageCallback"));
+    GfxBackend = Backend;
+
+    // NOTE: Draw lists are refilled every frame, so they are allocated once from the persistent arena
+    if(Backend == GFX_BACKEND_SOFT)
+    {
+        GfxSoft.Prims = gfxArenaPush(&GfxArena, GFX_SOFT_PRIMS * sizeof(gfx_prim));
+    }
+    else
+    {
+        gfx_draw* Draws[] = {&GfxDraw, &GfxPopupDraw};
+        for(u32 Idx = 0; Idx < ArrLen(Draws); Idx++)
+        {
+            Draws[Idx]->Vtx = gfxArenaPush(&GfxArena, GFX_DRAW_VTX * sizeof(gfx_vtx));
+            Draws[Idx]->Idx = gfxArenaPush(&GfxArena, GFX_DRAW_IDX * sizeof(u16));
+            Draws[Idx]->Cmd = gfxArenaPush(&GfxArena, GFX_DRAW_CMD * sizeof(gfx_cmd));
+        }
+    }
+
+    if(Backend != GFX_BACKEND_SOFT)
+    {
+#if GFX_GL
+        Assert(glDebugMessageCallback = (PFNGLDEBUGMESSAGECALLBACKPROC) gfxGlGetProcAddress("glDebugMessageCallback"));
+
+        glEnable(GL_DEBUG_OUTPUT);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        glDebugMessageCallback(gfxGlCallback, 0);
 
-    glEnable(GL_TEXTURE_2D);
-    glEnable(GL_DEBUG_OUTPUT);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-    glDebugMessageCallback(gfxGlCallback, 0);
+        if(Backend == GFX_BACKEND_CORE)
+        {
+            Assert(gfxCoreInit());
+        }
+        else
+        {
+            glEnable(GL_TEXTURE_2D);
+        }
+#else
+        gfxDebug("Built without OpenGL, only GFX_BACKEND_SOFT is available\n");
+        return 0;
+#endif
+    }
 
-    Assert(gfxLoadBdf(&GfxFnt, "spleen-32x64.bdf"));
+    Assert(gfxLoadFnt(&GfxFnt, "spleen-32x64.bdf"));
+    usz FntBytes = gfxFntBytes(&GfxFnt);
+    gfxDebug("Font: %zu bytes (%u bitmap, %u texture, %zu codes, index and rects)\n", FntBytes, GfxFnt.Size,
+             GfxFnt.TexSize, FntBytes - GfxFnt.Size - GfxFnt.TexSize);
     GfxFnt.Cols/=2;
     GfxFnt.Rows/=2;
 
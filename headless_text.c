@@ -0,0 +1,636 @@
+#include "gfx.c"
+#include "text.c"
+
+//
+// Input script, one event per line: <frame> <command> [args], '#' starts a comment
+//
+//   10 move 120 300    cursor position
+//   11 down            left button pressed
+//   12 up              left button released
+//   20 key right 3     key presses, one of left, right, up, down, shift
+//   30 wheel -2        wheel notches, positive away from the user
+//
+
+typedef enum
+{
+    SCRIPT_MOVE,
+    SCRIPT_DOWN,
+    SCRIPT_UP,
+    SCRIPT_KEY,
+    SCRIPT_WHEEL,
+} script_kind;
+
+typedef enum
+{
+    SCRIPT_KEY_LEFT,
+    SCRIPT_KEY_RIGHT,
+    SCRIPT_KEY_UP,
+    SCRIPT_KEY_DOWN,
+    SCRIPT_KEY_SHIFT,
+} script_key;
+
+typedef struct
+{
+    u32 Frame;
+    u32 Kind;
+    i32 A;
+    i32 B;
+} script_event;
+
+typedef struct
+{
+    u32 Count;
+    u32 Next;
+    script_event* Events;
+} script;
+
+static b32 ScriptLoad(script* Script, const char* Path)
+{
+    b32 Result = 0;
+
+    usz Size = 0;
+    char* Data = gfxLoadFile(Path, &Size);
+    if(Data)
+    {
+        // NOTE: Upper bound of events is the number of lines
+        u32 Lines = 1;
+        for(usz Idx = 0; Idx < Size; Idx++)
+        {
+            Lines += Data[Idx] == '\n';
+        }
+
+        Script->Count = 0;
+        Script->Next = 0;
+        Script->Events = gfxVirtualAlloc(Lines * sizeof(script_event));
+        if(Script->Events)
+        {
+            Result = 1;
+
+            u32 LineNumber = 0;
+            char* At = Data;
+            char* End = Data + Size;
+            while(At < End && Result)
+            {
+                char* Eol = memchr(At, '\n', End - At);
+                if(!Eol)
+                {
+                    Eol = End;
+                }
+
+                char Line[256];
+                usz Length = Min((usz)(Eol - At), sizeof(Line) - 1);
+                memcpy(Line, At, Length);
+                Line[Length] = 0;
+                At = Eol + 1;
+                LineNumber++;
+
+                char* Hash = strchr(Line, '#');
+                if(Hash)
+                {
+                    *Hash = 0;
+                }
+
+                u32 Frame;
+                char Command[16];
+                char Arg[16];
+                i32 X, Y;
+                int Fields = sscanf(Line, "%u %15s", &Frame, Command);
+                if(Fields == EOF)
+                {
+                    continue;
+                }
+
+                script_event* Event = &Script->Events[Script->Count];
+                Event->Frame = Frame;
+                Event->A = 0;
+                Event->B = 0;
+                if(Fields < 2)
+                {
+                    Result = 0;
+                }
+                else if(strcmp(Command, "move") == 0 && sscanf(Line, "%*u %*s %d %d", &X, &Y) == 2)
+                {
+                    Event->Kind = SCRIPT_MOVE;
+                    Event->A = X;
+                    Event->B = Y;
+                }
+                else if(strcmp(Command, "down") == 0)
+                {
+                    Event->Kind = SCRIPT_DOWN;
+                }
+                else if(strcmp(Command, "up") == 0)
+                {
+                    Event->Kind = SCRIPT_UP;
+                }
+                else if(strcmp(Command, "key") == 0 && sscanf(Line, "%*u %*s %15s", Arg) == 1)
+                {
+                    Event->Kind = SCRIPT_KEY;
+                    Event->B = 1;
+                    sscanf(Line, "%*u %*s %*s %d", &Event->B);
+
+                    if(strcmp(Arg, "left") == 0)       Event->A = SCRIPT_KEY_LEFT;
+                    else if(strcmp(Arg, "right") == 0) Event->A = SCRIPT_KEY_RIGHT;
+                    else if(strcmp(Arg, "up") == 0)    Event->A = SCRIPT_KEY_UP;
+                    else if(strcmp(Arg, "down") == 0)  Event->A = SCRIPT_KEY_DOWN;
+                    else if(strcmp(Arg, "shift") == 0) Event->A = SCRIPT_KEY_SHIFT;
+                    else Result = 0;
+                }
+                else if(strcmp(Command, "wheel") == 0 && sscanf(Line, "%*u %*s %d", &X) == 1)
+                {
+                    Event->Kind = SCRIPT_WHEEL;
+                    Event->A = X;
+                }
+                else
+                {
+                    Result = 0;
+                }
+
+                if(Result && Script->Count && Frame < Script->Events[Script->Count-1].Frame)
+                {
+                    Result = 0;
+                }
+
+                if(Result)
+                {
+                    Script->Count++;
+                }
+                else
+                {
+                    fprintf(stderr, "%s:%u: invalid or out of order event\n", Path, LineNumber);
+                }
+            }
+
+            if(!Result)
+            {
+                gfxVirtualFree(Script->Events);
+                Script->Events = 0;
+            }
+        }
+
+        gfxVirtualFree(Data);
+    }
+
+    return Result;
+}
+
+// NOTE: Applies the events of the given frame, the key counters are reset by the caller after every frame
+static void ScriptFeed(script* Script, u32 Frame)
+{
+    while(Script->Next < Script->Count && Script->Events[Script->Next].Frame <= Frame)
+    {
+        script_event* Event = &Script->Events[Script->Next++];
+        switch(Event->Kind)
+        {
+            case SCRIPT_MOVE:
+            {
+                GfxCur[0] = (f32) Event->A;
+                GfxCur[1] = (f32) Event->B;
+            } break;
+
+            case SCRIPT_DOWN:
+            {
+                GfxBtn = 1;
+            } break;
+
+            case SCRIPT_UP:
+            {
+                GfxBtn = 0;
+            } break;
+
+            case SCRIPT_KEY:
+            {
+                switch(Event->A)
+                {
+                    case SCRIPT_KEY_LEFT:  GfxKeyLeft += Event->B; break;
+                    case SCRIPT_KEY_RIGHT: GfxKeyRight += Event->B; break;
+                    case SCRIPT_KEY_UP:    GfxKeyUp += Event->B; break;
+                    case SCRIPT_KEY_DOWN:  GfxKeyDown += Event->B; break;
+                    case SCRIPT_KEY_SHIFT: GfxKeyShift = 1; break;
+                }
+            } break;
+
+            case SCRIPT_WHEEL:
+            {
+                GfxWheel = (i8) Clamp(-128, 127, GfxWheel + Event->A);
+            } break;
+        }
+    }
+}
+
+// NOTE: Synthetic screen for benchmarking, the existing widgets tiled over the whole target. All panels are
+// drawn between one gfxBegin and gfxEnd, so a frame is binned and rasterized by the threads in one flush.
+static void BenchUpdate(void)
+{
+    static f32 Progress = 0.0f;
+    static f32 Slider = 150.0f;
+    static i32 Radio = 1;
+    static b32 Check = 1;
+    static const char* Combo = "Select something";
+
+    gfxClear(0.0f, 0.0f, 0.0f);
+
+    f32 PanelCols = 440.0f;
+    f32 PanelRows = 7.0f * (GfxFnt.Rows + GfxSep) + GfxSep;
+    gfxBegin();
+    for(f32 Y = 0.0f; Y < GfxRows; Y += PanelRows)
+    {
+        for(f32 X = 0.0f; X < GfxCols; X += PanelCols)
+        {
+            GfxPos[0] = X + GfxSep;
+            GfxPos[1] = Y + GfxSep;
+
+            // NOTE: Every panel repeats the same labels, so they need their own ID scope
+            gfxPushIdInt((i32)(Y * GfxCols + X));
+
+            gfxColor3f(1.0f, 1.0f, 1.0f);
+            gfxRectLines(X + GfxSep/2, Y + GfxSep/2, X + PanelCols - GfxSep/2, Y + PanelRows - GfxSep/2);
+            gfxString("Za\xc5\xbc\xc3\xb3\xc5\x82\xc4\x87 g\xc4\x99\xc5\x9bl\xc4\x85 ja\xc5\xba\xc5\x84");
+            gfxButton("Push me");
+            gfxRadioButton("Radio button", &Radio, 1);
+            gfxCheckBox("Check box", &Check);
+            gfxSliderFloat(100.0f, 200.0f, &Slider, "%.1lf");
+            gfxProgressBar(0.0f, 100.0f, &Progress, "%.0f%%");
+            gfxComboBox(&Combo, 0, 0);
+            gfxPopId();
+        }
+    }
+    gfxEnd();
+
+    gfxEndFrame();
+
+    Progress += 1.0f;
+    if(Progress > 100.0f)
+    {
+        Progress = 0.0f;
+    }
+}
+
+static f64 BenchRun(u32 Threads, u32 Frames)
+{
+    gfxSoftThreads(Threads);
+
+    // NOTE: Warm up caches and the bin buffer before measuring
+    BenchUpdate();
+
+    u64 Start = gfxClock();
+    for(u32 Frame = 0; Frame < Frames; Frame++)
+    {
+        BenchUpdate();
+    }
+    u64 End = gfxClock();
+
+    return (End - Start) / (1000000.0 * Frames);
+}
+
+static f32 BenchRandom(u32* State)
+{
+    *State = *State * 1664525u + 1013904223u;
+    return (*State >> 8) / (f32)(1 << 24) * 2.0f - 1.0f;
+}
+
+static f32 BenchMaxError(const f32* A, const f32* B, usz Count)
+{
+    f32 Result = 0.0f;
+    for(usz Idx = 0; Idx < Count; Idx++)
+    {
+        Result = Max(Result, fabsf(A[Idx] - B[Idx]));
+    }
+    return Result;
+}
+
+#define BENCH_MATRICES 4096
+#define BENCH_POINTS 0x10000
+
+// NOTE: Nanoseconds per operation of the scalar and SIMD matrix functions, and how far apart their results are
+static void BenchMath(u32 Rounds)
+{
+#if GFX_SIMD
+    static m4f In[BENCH_MATRICES];
+    static m4f OutScalar[BENCH_MATRICES];
+    static m4f OutSimd[BENCH_MATRICES];
+    static v2f Points[BENCH_POINTS];
+    static v2f PointsScalar[BENCH_POINTS];
+    static v2f PointsSimd[BENCH_POINTS];
+
+    u32 State = 1;
+    for(u32 Idx = 0; Idx < BENCH_MATRICES; Idx++)
+    {
+        for(u32 Elem = 0; Elem < 16; Elem++)
+        {
+            In[Idx][Elem] = BenchRandom(&State);
+        }
+
+        // NOTE: Keep the matrices well conditioned for the inverse
+        In[Idx][0] += 4.0f;
+        In[Idx][5] += 4.0f;
+        In[Idx][10] += 4.0f;
+        In[Idx][15] += 4.0f;
+    }
+
+    for(u32 Idx = 0; Idx < BENCH_POINTS; Idx++)
+    {
+        Points[Idx][0] = 1000.0f * BenchRandom(&State);
+        Points[Idx][1] = 1000.0f * BenchRandom(&State);
+    }
+
+    printf("%-16s %10s %10s %8s %12s\n", "", "scalar ns", "simd ns", "speedup", "max error");
+
+    u64 Start, ScalarNs, SimdNs;
+    u64 Ops = (u64)Rounds * BENCH_MATRICES;
+
+    Start = gfxClock();
+    for(u32 Round = 0; Round < Rounds; Round++)
+        for(u32 Idx = 0; Idx < BENCH_MATRICES; Idx++)
+            gfxMulScalar(OutScalar[Idx], In[Idx], In[(Idx + 1) % BENCH_MATRICES]);
+    ScalarNs = gfxClock() - Start;
+    Start = gfxClock();
+    for(u32 Round = 0; Round < Rounds; Round++)
+        for(u32 Idx = 0; Idx < BENCH_MATRICES; Idx++)
+            gfxMulSimd(OutSimd[Idx], In[Idx], In[(Idx + 1) % BENCH_MATRICES]);
+    SimdNs = gfxClock() - Start;
+    printf("%-16s %10.2f %10.2f %7.2fx %12g\n", "multiply", (f64)ScalarNs / Ops, (f64)SimdNs / Ops,
+           (f64)ScalarNs / SimdNs, BenchMaxError(&OutScalar[0][0], &OutSimd[0][0], 16 * BENCH_MATRICES));
+
+    Start = gfxClock();
+    for(u32 Round = 0; Round < Rounds; Round++)
+        for(u32 Idx = 0; Idx < BENCH_MATRICES; Idx++)
+            gfxTransposeScalar(OutScalar[Idx], In[Idx]);
+    ScalarNs = gfxClock() - Start;
+    Start = gfxClock();
+    for(u32 Round = 0; Round < Rounds; Round++)
+        for(u32 Idx = 0; Idx < BENCH_MATRICES; Idx++)
+            gfxTransposeSimd(OutSimd[Idx], In[Idx]);
+    SimdNs = gfxClock() - Start;
+    printf("%-16s %10.2f %10.2f %7.2fx %12g\n", "transpose", (f64)ScalarNs / Ops, (f64)SimdNs / Ops,
+           (f64)ScalarNs / SimdNs, BenchMaxError(&OutScalar[0][0], &OutSimd[0][0], 16 * BENCH_MATRICES));
+
+    Start = gfxClock();
+    for(u32 Round = 0; Round < Rounds; Round++)
+        for(u32 Idx = 0; Idx < BENCH_MATRICES; Idx++)
+            gfxInverseScalar(OutScalar[Idx], In[Idx]);
+    ScalarNs = gfxClock() - Start;
+    Start = gfxClock();
+    for(u32 Round = 0; Round < Rounds; Round++)
+        for(u32 Idx = 0; Idx < BENCH_MATRICES; Idx++)
+            gfxInverseSimd(OutSimd[Idx], In[Idx]);
+    SimdNs = gfxClock() - Start;
+    printf("%-16s %10.2f %10.2f %7.2fx %12g\n", "inverse", (f64)ScalarNs / Ops, (f64)SimdNs / Ops,
+           (f64)ScalarNs / SimdNs, BenchMaxError(&OutScalar[0][0], &OutSimd[0][0], 16 * BENCH_MATRICES));
+
+    // NOTE: M * inverse(M) should come back as identity
+    f32 IdentityError = 0.0f;
+    for(u32 Idx = 0; Idx < BENCH_MATRICES; Idx++)
+    {
+        m4f Product, Identity;
+        gfxMulSimd(Product, In[Idx], OutSimd[Idx]);
+        gfxIdentity(Identity);
+        IdentityError = Max(IdentityError, BenchMaxError(Product, Identity, 16));
+    }
+    printf("%-16s %45g\n", "inverse check", IdentityError);
+
+    m4f M = {0};
+    gfxIdentity(M);
+    v3f Offset = {10.0f, 20.0f, 0.0f};
+    v3f Factor = {2.0f, 0.5f, 1.0f};
+    gfxScale(M, Factor);
+    gfxTranslate(M, Offset);
+    M[1] = 0.25f;
+    M[4] = -0.25f;
+
+    Ops = (u64)Rounds * BENCH_POINTS;
+    ScalarNs = 0;
+    SimdNs = 0;
+    for(u32 Round = 0; Round < Rounds; Round++)
+    {
+        memcpy(PointsScalar, Points, sizeof(Points));
+        memcpy(PointsSimd, Points, sizeof(Points));
+
+        Start = gfxClock();
+        gfxTransformPointsScalar(M, &PointsScalar[0][0], BENCH_POINTS, sizeof(v2f));
+        ScalarNs += gfxClock() - Start;
+
+        Start = gfxClock();
+        gfxTransformPointsSimd(M, &PointsSimd[0][0], BENCH_POINTS, sizeof(v2f));
+        SimdNs += gfxClock() - Start;
+    }
+    printf("%-16s %10.2f %10.2f %7.2fx %12g\n", "transform point", (f64)ScalarNs / Ops, (f64)SimdNs / Ops,
+           (f64)ScalarNs / SimdNs, BenchMaxError(&PointsScalar[0][0], &PointsSimd[0][0], 2 * BENCH_POINTS));
+#else
+    printf("Built with BUILD_SCALAR, there is no SIMD path to compare\n");
+#endif
+}
+
+int main(int Argc, char** Argv)
+{
+    u32 Cols = 800;
+    u32 Rows = 600;
+    u32 Frames = 1;
+    u32 Threads = 1;
+    f32 Fps = 60.0f;
+    b32 Bench = 0;
+    b32 BenchMathOnly = 0;
+    const char* Input = 0;
+    const char* Replay = 0;
+    const char* Trace = 0;
+    const char* Output = "text.bmp";
+    for(int Idx = 1; Idx < Argc; Idx++)
+    {
+        if(strcmp(Argv[Idx], "--size") == 0 && Idx + 1 < Argc)
+        {
+            if(sscanf(Argv[++Idx], "%ux%u", &Cols, &Rows) != 2 || !Cols || !Rows)
+            {
+                fprintf(stderr, "Invalid size, expected WxH\n");
+                return 1;
+            }
+        }
+        else if(strcmp(Argv[Idx], "--frames") == 0 && Idx + 1 < Argc)
+        {
+            Frames = (u32) atoi(Argv[++Idx]);
+        }
+        else if(strcmp(Argv[Idx], "--fps") == 0 && Idx + 1 < Argc)
+        {
+            Fps = (f32) atof(Argv[++Idx]);
+            if(Fps <= 0.0f)
+            {
+                fprintf(stderr, "Invalid frame rate\n");
+                return 1;
+            }
+        }
+        else if(strcmp(Argv[Idx], "--threads") == 0 && Idx + 1 < Argc)
+        {
+            Threads = (u32) atoi(Argv[++Idx]);
+        }
+        else if(strcmp(Argv[Idx], "--input") == 0 && Idx + 1 < Argc)
+        {
+            Input = Argv[++Idx];
+        }
+        else if(strcmp(Argv[Idx], "--trace") == 0 && Idx + 1 < Argc)
+        {
+            Trace = Argv[++Idx];
+        }
+        else if(strcmp(Argv[Idx], "--replay") == 0 && Idx + 1 < Argc)
+        {
+            Replay = Argv[++Idx];
+        }
+        else if(strcmp(Argv[Idx], "--output") == 0 && Idx + 1 < Argc)
+        {
+            Output = Argv[++Idx];
+        }
+        else if(strcmp(Argv[Idx], "--bench") == 0)
+        {
+            Bench = 1;
+        }
+        else if(strcmp(Argv[Idx], "--bench-math") == 0)
+        {
+            BenchMathOnly = 1;
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--size WxH] [--frames N] [--fps N] [--threads N] [--input script] [--replay log] [--trace file.json] [--output file.bmp] [--bench] [--bench-math]\n", Argv[0]);
+            return 1;
+        }
+    }
+
+    if(BenchMathOnly)
+    {
+        BenchMath(Max(Frames, 100));
+        return 0;
+    }
+
+    gfx_play Play = {0};
+    if(Replay)
+    {
+        if(!gfxPlayOpen(&Play, Replay))
+        {
+            fprintf(stderr, "Failed to load input log %s\n", Replay);
+            return 1;
+        }
+
+        // NOTE: Framebuffer fits the largest recorded window, frames render at their recorded size
+        Cols = 1;
+        Rows = 1;
+        for(u32 Idx = 0; Idx < Play.Hdr->Count; Idx++)
+        {
+            Cols = Max(Cols, Play.Inputs[Idx].Cols);
+            Rows = Max(Rows, Play.Inputs[Idx].Rows);
+        }
+        Frames = Play.Hdr->Frames;
+    }
+
+    u32* Pixels = gfxVirtualAlloc((usz)Cols * Rows * sizeof(u32));
+    if(!Pixels)
+    {
+        perror("Failed to allocate framebuffer");
+        return 1;
+    }
+
+    Assert(gfxInit(GFX_BACKEND_SOFT));
+    gfxSoftTarget(Pixels, Cols, Rows);
+
+    if(Bench)
+    {
+        // NOTE: Powers of two up to --threads, or up to the CPU count when it is 0
+        u32 MaxThreads = Threads ? Threads : gfxCpuCount();
+        MaxThreads = Min(MaxThreads, GFX_SOFT_THREADS);
+        Frames = Max(Frames, 10);
+
+        printf("%ux%u, %u frames, %u CPUs\n", Cols, Rows, Frames, gfxCpuCount());
+
+        f64 Base = 0.0;
+        for(u32 Count = 1; ; Count = Min(2 * Count, MaxThreads))
+        {
+            f64 Ms = BenchRun(Count, Frames);
+            if(Count == 1)
+            {
+                Base = Ms;
+            }
+
+            printf("%2u threads: %8.3f ms/frame, %5.2fx\n", Count, Ms, Base / Ms);
+
+            if(Count == MaxThreads)
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        script Script = {0};
+        if(Input)
+        {
+            if(!ScriptLoad(&Script, Input))
+            {
+                fprintf(stderr, "Failed to load input script %s\n", Input);
+                return 1;
+            }
+
+            if(Script.Count)
+            {
+                Frames = Max(Frames, Script.Events[Script.Count-1].Frame + 1);
+            }
+        }
+
+        u64* Times = gfxVirtualAlloc(Max(Frames, 1) * sizeof(u64));
+        if(!Times)
+        {
+            perror("Failed to allocate frame times");
+            return 1;
+        }
+
+        gfxSoftThreads(Threads);
+
+        u32 Frame = 0;
+        for(; Frame < Frames; Frame++)
+        {
+            if(Play.Data)
+            {
+                if(!gfxPlayFrame(&Play))
+                {
+                    break;
+                }
+
+                // NOTE: Replayed size may be smaller than the framebuffer, keep rows packed
+                u32 FrameCols = Max((u32)GfxCols, 1);
+                u32 FrameRows = Max((u32)GfxRows, 1);
+                gfxSoftTarget(Pixels, FrameCols, FrameRows);
+                Cols = FrameCols;
+                Rows = FrameRows;
+            }
+            else
+            {
+                // NOTE: Fixed clock steps keep time-based animation deterministic
+                gfxStepFrame(1.0f / Fps);
+            }
+
+            ScriptFeed(&Script, Frame);
+
+            u64 Start = gfxClock();
+            GFX_TRACE_BEGIN("AppUpdate");
+            AppUpdate();
+            GFX_TRACE_END("AppUpdate");
+            Times[Frame] = gfxClock() - Start;
+
+            GfxKeyLeft = 0;
+            GfxKeyRight = 0;
+            GfxKeyUp = 0;
+            GfxKeyDown = 0;
+            GfxKeyShift = 0;
+            GfxWheel = 0;
+        }
+
+        gfxTimeReport(Times, Frame);
+    }
+
+    if(Trace && !gfxTraceDump(Trace, Frames))
+    {
+        fprintf(stderr, "Failed to write trace\n");
+    }
+
+    if(!gfxSaveBmp(Output, Pixels, Cols, Rows))
+    {
+        perror("Failed to save output");
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,8 +1,67 @@
 #include "gfx.c"
 #include "text.c"
 
+#include <poll.h>
+
+typedef GLXContext (*PFNGLXCREATECONTEXTATTRIBSARBPROC)(Display*, GLXFBConfig, GLXContext, Bool, const int*);
+
 int main(int Argc, char** Argv)
 {
+    gfx_backend Backend = GFX_BACKEND_COMPAT;
+    b32 VSync = 1;
+    const char* RecordPath = 0;
+    const char* ReplayPath = 0;
+    const char* TracePath = 0;
+    u32 TraceFrames = 120;
+    for(int Idx = 1; Idx < Argc; Idx++)
+    {
+        if(strcmp(Argv[Idx], "--core") == 0)
+        {
+            Backend = GFX_BACKEND_CORE;
+        }
+        else if(strcmp(Argv[Idx], "--no-vsync") == 0)
+        {
+            VSync = 0;
+        }
+        else if(strcmp(Argv[Idx], "--record") == 0 && Idx + 1 < Argc)
+        {
+            RecordPath = Argv[++Idx];
+        }
+        else if(strcmp(Argv[Idx], "--trace") == 0 && Idx + 1 < Argc)
+        {
+            TracePath = Argv[++Idx];
+        }
+        else if(strcmp(Argv[Idx], "--trace-frames") == 0 && Idx + 1 < Argc)
+        {
+            TraceFrames = (u32) atoi(Argv[++Idx]);
+        }
+        else if(strcmp(Argv[Idx], "--replay") == 0 && Idx + 1 < Argc)
+        {
+            ReplayPath = Argv[++Idx];
+        }
+    }
+
+    gfx_rec Rec = {0};
+    if(RecordPath && !gfxRecOpen(&Rec, RecordPath))
+    {
+        perror("Failed to open input log for recording");
+        return 1;
+    }
+
+    gfx_play Play = {0};
+    u64* Times = 0;
+    u32 TimeCount = 0;
+    if(ReplayPath)
+    {
+        if(!gfxPlayOpen(&Play, ReplayPath))
+        {
+            perror("Failed to open input log for replay");
+            return 1;
+        }
+
+        Times = gfxVirtualAlloc(((usz)Play.Hdr->Frames + 1) * sizeof(u64));
+    }
+
     setenv("DISPLAY", ":0", 1); // TODO: Fix that
     Display* X11Display = XOpenDisplay(0);
     if(!X11Display)
@@ -14,15 +73,31 @@ int main(int Argc, char** Argv)
     Window X11Root = DefaultRootWindow(X11Display);
     GLint GlAttributes[] =
     {
-        GLX_RGBA,
+        GLX_X_RENDERABLE, True,
+        GLX_DRAWABLE_TYPE, GLX_WINDOW_BIT,
+        GLX_RENDER_TYPE, GLX_RGBA_BIT,
+        GLX_RED_SIZE, 8,
+        GLX_GREEN_SIZE, 8,
+        GLX_BLUE_SIZE, 8,
         GLX_DEPTH_SIZE, 24,
-        GLX_DOUBLEBUFFER,
+        GLX_DOUBLEBUFFER, True,
         GLX_SAMPLE_BUFFERS, 1,
         GLX_SAMPLES, 4,
         None
     };
 
-    XVisualInfo* X11VisualInfo = glXChooseVisual(X11Display, 0, GlAttributes);
+    int GlConfigCount = 0;
+    GLXFBConfig* GlConfigs = glXChooseFBConfig(X11Display, DefaultScreen(X11Display), GlAttributes, &GlConfigCount);
+    if(!GlConfigs || !GlConfigCount)
+    {
+        perror("No appropriate framebuffer config found for display");
+        return 1;
+    }
+
+    GLXFBConfig GlConfig = GlConfigs[0];
+    XFree(GlConfigs);
+
+    XVisualInfo* X11VisualInfo = glXGetVisualFromFBConfig(X11Display, GlConfig);
     if(!X11VisualInfo)
     {
         perror("No appropriate visual found for display");
@@ -33,13 +108,37 @@ int main(int Argc, char** Argv)
 
     XSetWindowAttributes X11WindowAttributes = {0};
     X11WindowAttributes.colormap = X11Colormap;
-    X11WindowAttributes.event_mask = ExposureMask|KeyPressMask|PointerMotionMask|ButtonPressMask|ButtonReleaseMask;
+    X11WindowAttributes.event_mask = ExposureMask|KeyPressMask|PointerMotionMask|ButtonPressMask|ButtonReleaseMask|StructureNotifyMask;
     Window X11Window = XCreateWindow(X11Display, X11Root, 0, 0, 800, 600, 0, X11VisualInfo->depth,
                                      InputOutput, X11VisualInfo->visual, CWColormap|CWEventMask, &X11WindowAttributes);
     XStoreName(X11Display, X11Window, "Text view");
+    GfxCols = 800;
+    GfxRows = 600;
     XMapWindow(X11Display, X11Window);
 
-    GLXContext GlContext = glXCreateContext(X11Display, X11VisualInfo, 0, GL_TRUE);
+    GLXContext GlContext = 0;
+    if(Backend == GFX_BACKEND_CORE)
+    {
+        PFNGLXCREATECONTEXTATTRIBSARBPROC glXCreateContextAttribsARB =
+            (PFNGLXCREATECONTEXTATTRIBSARBPROC) glXGetProcAddress((const GLubyte*) "glXCreateContextAttribsARB");
+        if(glXCreateContextAttribsARB)
+        {
+            int GlContextAttributes[] =
+            {
+                GLX_CONTEXT_MAJOR_VERSION_ARB, 3,
+                GLX_CONTEXT_MINOR_VERSION_ARB, 3,
+                GLX_CONTEXT_PROFILE_MASK_ARB, GLX_CONTEXT_CORE_PROFILE_BIT_ARB,
+                None
+            };
+
+            GlContext = glXCreateContextAttribsARB(X11Display, GlConfig, 0, True, GlContextAttributes);
+        }
+    }
+    else
+    {
+        GlContext = glXCreateNewContext(X11Display, GlConfig, GLX_RGBA_TYPE, 0, True);
+    }
+
     if(!GlContext)
     {
         perror("Failed to create gl context");
@@ -48,17 +147,69 @@ int main(int Argc, char** Argv)
 
     glXMakeCurrent(X11Display, X11Window, GlContext);
 
+    const char* GlxExtensions = glXQueryExtensionsString(X11Display, DefaultScreen(X11Display));
+    if(GlxExtensions && strstr(GlxExtensions, "GLX_EXT_swap_control"))
+    {
+        PFNGLXSWAPINTERVALEXTPROC glXSwapIntervalEXT =
+            (PFNGLXSWAPINTERVALEXTPROC) glXGetProcAddress((const GLubyte*) "glXSwapIntervalEXT");
+        if(glXSwapIntervalEXT)
+        {
+            glXSwapIntervalEXT(X11Display, X11Window, VSync);
+        }
+    }
+    else if(GlxExtensions && strstr(GlxExtensions, "GLX_MESA_swap_control"))
+    {
+        PFNGLXSWAPINTERVALMESAPROC glXSwapIntervalMESA =
+            (PFNGLXSWAPINTERVALMESAPROC) glXGetProcAddress((const GLubyte*) "glXSwapIntervalMESA");
+        if(glXSwapIntervalMESA)
+        {
+            glXSwapIntervalMESA(VSync);
+        }
+    }
+    else
+    {
+        gfxDebug("No swap control extension, vsync is left to the driver\n");
+    }
+
     Atom WM_DELETE_WINDOW = XInternAtom(X11Display, "WM_DELETE_WINDOW", False);
     XSetWMProtocols(X11Display, X11Window, &WM_DELETE_WINDOW, 1);
 
-    Assert(gfxInit());
+    Assert(gfxInit(Backend));
 
     glEnable(GL_MULTISAMPLE);
 
+    // NOTE: Press and release within one batch of events still give the button one frame held down
+    b32 BtnPressed = 0;
+    b32 BtnReleased = 0;
+
+    // NOTE: Frame scheduler, sleeps until input arrives or a widget asked for a frame
+    u32 WaitMs = GFX_WAIT_FOREVER;
+
     u32 ShouldExit = 0;
     while(ShouldExit == 0)
     {
-        do
+        // NOTE: Replay runs frames back to back, so it only drains pending events
+        if(Play.Data || BtnReleased)
+        {
+            WaitMs = 0;
+        }
+
+        if(BtnReleased)
+        {
+            GfxBtn = 0;
+            BtnReleased = 0;
+        }
+
+        if(WaitMs && !XPending(X11Display))
+        {
+            struct pollfd X11Poll = {0};
+            X11Poll.fd = ConnectionNumber(X11Display);
+            X11Poll.events = POLLIN;
+            poll(&X11Poll, 1, WaitMs == GFX_WAIT_FOREVER ? -1 : (int)WaitMs);
+        }
+
+        BtnPressed = 0;
+        while(XPending(X11Display))
         {
             XEvent X11Event;
             XNextEvent(X11Display, &X11Event);
@@ -99,6 +250,50 @@ int main(int Argc, char** Argv)
                     } break;
                 }
             }
+            else if(X11Event.type == MotionNotify)
+            {
+                GfxCur[0] = X11Event.xmotion.x;
+                GfxCur[1] = X11Event.xmotion.y;
+            }
+            else if(X11Event.type == ButtonPress)
+            {
+                GfxCur[0] = X11Event.xbutton.x;
+                GfxCur[1] = X11Event.xbutton.y;
+                if(X11Event.xbutton.button == Button1)
+                {
+                    GfxBtn = 1;
+                    BtnPressed = 1;
+                }
+                else if(X11Event.xbutton.button == Button4)
+                {
+                    GfxWheel++;
+                }
+                else if(X11Event.xbutton.button == Button5)
+                {
+                    GfxWheel--;
+                }
+            }
+            else if(X11Event.type == ButtonRelease)
+            {
+                GfxCur[0] = X11Event.xbutton.x;
+                GfxCur[1] = X11Event.xbutton.y;
+                if(X11Event.xbutton.button == Button1)
+                {
+                    if(BtnPressed)
+                    {
+                        BtnReleased = 1;
+                    }
+                    else
+                    {
+                        GfxBtn = 0;
+                    }
+                }
+            }
+            else if(X11Event.type == ConfigureNotify)
+            {
+                GfxCols = X11Event.xconfigure.width;
+                GfxRows = X11Event.xconfigure.height;
+            }
             else if(X11Event.type == ClientMessage)
             {
                 if(X11Event.xclient.data.l[0] == (int)WM_DELETE_WINDOW)
@@ -106,31 +301,61 @@ int main(int Argc, char** Argv)
                     ShouldExit = 1;
                 }
             }
-        } while(XPending(X11Display));
-
-        XWindowAttributes X11Attributes;
-        XGetWindowAttributes(X11Display, X11Window, &X11Attributes);
-        GfxCols = X11Attributes.width;
-        GfxRows = X11Attributes.height;
-
-        unsigned BtnsMask;
-        int WinCurX, WinCurY;
-        int RootCurX, RootCurY;
-        Window X11ChildReturnWindow;
-        XQueryPointer(X11Display, X11Root, &X11Root, &X11ChildReturnWindow, &RootCurX, &RootCurY, &WinCurX, &WinCurY, &BtnsMask);
-        XTranslateCoordinates(X11Display, X11Root, X11Window, RootCurX, RootCurY, &WinCurX, &WinCurY, &X11ChildReturnWindow);
-        GfxCur[0] = WinCurX;
-        GfxCur[1] = WinCurY;
-        GfxBtn = (BtnsMask & Button1Mask);
+        }
 
+        if(Play.Data)
+        {
+            if(!gfxPlayFrame(&Play))
+            {
+                break;
+            }
+        }
+        else
+        {
+            gfxNewFrame();
+        }
+
+        if(Rec.File)
+        {
+            gfxRecFrame(&Rec);
+        }
+
+        u64 FrameStart = gfxClock();
+        GFX_TRACE_BEGIN("AppUpdate");
         AppUpdate();
+        GFX_TRACE_END("AppUpdate");
+        if(Times)
+        {
+            Times[TimeCount++] = gfxClock() - FrameStart;
+        }
 
         GfxKeyLeft = 0;
         GfxKeyRight = 0;
         GfxKeyUp = 0;
         GfxKeyDown = 0;
         GfxKeyShift = 0;
+        GfxWheel = 0;
 
+        WaitMs = gfxFrameWait();
+
+        GFX_TRACE_BEGIN("glXSwapBuffers");
         glXSwapBuffers(X11Display, X11Window);
+        GFX_TRACE_END("glXSwapBuffers");
+    }
+
+    if(TracePath && !gfxTraceDump(TracePath, TraceFrames))
+    {
+        fprintf(stderr, "Failed to write trace\n");
+    }
+
+    if(Rec.File && !gfxRecClose(&Rec))
+    {
+        perror("Failed to write input log");
+    }
+
+    if(Play.Data)
+    {
+        gfxTimeReport(Times, TimeCount);
+        gfxPlayClose(&Play);
     }
 }
\ No newline at end of file
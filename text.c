@@ -1,4 +1,5 @@
 gfx_img TestBmp;
+gfx_view SourceView;
 
 static void AppUpdate(void)
 {
@@ -8,38 +9,20 @@ static void AppUpdate(void)
         Assert(gfxLoadBmp(&TestBmp, "test.bmp"));
         TestBmp.Cols /= 4;
         TestBmp.Rows /= 4;
+        gfxViewFollow(&SourceView, "gfx.c");
+        SourceView.Tail = 0;
+        gfxViewFind(&SourceView, "gfxView", 7);
         Initialized = 1;
     }
 
-    glViewport(0, 0, (i32)GfxCols, (i32)GfxRows);
-
-    glClearColor(0.0f, 0, 0, 0);
-    glClear(GL_COLOR_BUFFER_BIT);
-    glClear(GL_DEPTH_BUFFER_BIT);
-
-    m4f ProjectionMatrix;
-    gfxIdentity(ProjectionMatrix);
-    gfxOrtho(ProjectionMatrix, 0, GfxCols, 0, GfxRows, -1.0f, 1.0f);
-    glMatrixMode(GL_PROJECTION);
-    glLoadMatrixf(ProjectionMatrix);
-
-    m4f ModelViewMatrix;
-    gfxIdentity(ModelViewMatrix);
-    gfxTranslateY(ModelViewMatrix, GfxRows);
-    gfxScaleY(ModelViewMatrix, -1.0f);
-    glMatrixMode(GL_MODELVIEW);
-    glLoadMatrixf(ModelViewMatrix);
-
-    m4f TextureMatrix;
-    gfxIdentity(TextureMatrix);
-    glMatrixMode(GL_TEXTURE);
-    glLoadMatrixf(TextureMatrix);
+    gfxClear(0.0f, 0.0f, 0.0f);
 
     gfxBegin();
     {
-        glColor3f(1.0f, 1.0f, 1.0f);
+        gfxColor3f(1.0f, 1.0f, 1.0f);
         gfxString("Hello world!");
         gfxString("Welcome to Windows.");
+        gfxString("\xe2\x94\x82 Za\xc5\xbc\xc3\xb3\xc5\x82\xc4\x87 g\xc4\x99\xc5\x9bl\xc4\x85 ja\xc5\xba\xc5\x84 \xe2\x94\x82");
 
         if(gfxButton("Push me"))
         {
@@ -76,39 +59,56 @@ static void AppUpdate(void)
     gfxBegin();
     {
         GfxPos[0] += 500;
-        gfxGroupBox("Some group");
-
-        if(gfxButton("Yet another"))
+        if(gfxGroupBox("Some group", 400.0f, 200.0f))
         {
-            gfxDebugPrint("Yet another");
+            if(gfxButton("Yet another"))
+            {
+                gfxDebugPrint("Yet another");
+            }
+
+            static f32 Progress = 25.f;
+            gfxProgressBar(0.f, 100.f, &Progress, "%.0f%%");
+            Progress += 60.0f * GfxDelta;
+            if(Progress > 100)
+            {
+                Progress = 0;
+            }
+            gfxRequestFrame(0);
+
+            static char* ComboChoice = "Select something";
+            static const char* ComboOptions[] = {"Option one", "Option two", "Option three"};
+            gfxComboBox(&ComboChoice, ComboOptions, 3);
         }
+        gfxGroupBoxEnd();
+    }
+    gfxEnd();
 
-        static f32 Progress = 25.f;
-        gfxProgressBar(0.f, 100.f, &Progress, "%.0f%%");
-        Progress += 1;
-        if(Progress > 100)
+    gfxBegin();
+    {
+        GfxPos[0] = GfxCols - 27 * GfxFnt.Cols - GfxSep;
+        GfxPos[1] += 240;
+        gfxOverlay();
+
+        if(gfxButton("Next gfxView"))
         {
-            Progress = 0;
+            gfxViewJump(&SourceView, 1);
         }
 
-        static char* ComboChoice = "Select something";
-        static const char* ComboOptions[] = {"Option one", "Option two", "Option three"};
-        gfxComboBox(&ComboChoice, ComboOptions, 3);
+        // NOTE: Down to the bottom of the window, at least a few lines
+        u32 ViewRows = (u32)Max(3.0f, (GfxRows - GfxPos[1] - GfxSep) / GfxFnt.Rows);
+        gfxColor3f(0.75f, 0.75f, 0.75f);
+        gfxTextView(&SourceView, 26, ViewRows);
     }
     gfxEnd();
 
-    GfxPos[0] = GfxCur[0];
-    GfxPos[1] = GfxCur[1];
-    glColor3f(1.0f, 0.0f, 0.0f);
-    gfxString("I am moving");
-
-    if(!GfxBtn)
+    gfxBegin();
     {
-        if(GfxHot)
-        {
-            GfxPrevHot = GfxHot;
-        }
-
-        GfxHot = 0;
+        GfxPos[0] = GfxCur[0];
+        GfxPos[1] = GfxCur[1];
+        gfxColor3f(1.0f, 0.0f, 0.0f);
+        gfxString("I am moving");
     }
+    gfxEnd();
+
+    gfxEndFrame();
 }
\ No newline at end of file
@@ -9,15 +9,46 @@ static LRESULT WindowProc(HWND Window, UINT Msg, WPARAM WParam, LPARAM LParam)
     {
         case WM_KEYDOWN:
         {
+            // NOTE: Auto-repeat also sends WM_KEYDOWN, so held keys step at the keyboard repeat rate
+            if(GetKeyState(VK_SHIFT) < 0)
+            {
+                GfxKeyShift = 1;
+            }
+
             switch(WParam)
             {
                 case VK_ESCAPE:
                 {
                     PostQuitMessage(0);
                 } break;
+
+                case VK_LEFT:
+                {
+                    GfxKeyLeft++;
+                } break;
+
+                case VK_RIGHT:
+                {
+                    GfxKeyRight++;
+                } break;
+
+                case VK_UP:
+                {
+                    GfxKeyUp++;
+                } break;
+
+                case VK_DOWN:
+                {
+                    GfxKeyDown++;
+                } break;
             }
         } break;
 
+        case WM_MOUSEWHEEL:
+        {
+            GfxWheel += GET_WHEEL_DELTA_WPARAM(WParam) / WHEEL_DELTA;
+        } break;
+
         case WM_CLOSE:
         {
             PostQuitMessage(0);
@@ -34,8 +65,28 @@ static LRESULT WindowProc(HWND Window, UINT Msg, WPARAM WParam, LPARAM LParam)
 
 static HWND Window;
 
+#define WGL_CONTEXT_MAJOR_VERSION_ARB     0x2091
+#define WGL_CONTEXT_MINOR_VERSION_ARB     0x2092
+#define WGL_CONTEXT_PROFILE_MASK_ARB      0x9126
+#define WGL_CONTEXT_CORE_PROFILE_BIT_ARB  0x00000001
+
+typedef HGLRC (WINAPI* PFNWGLCREATECONTEXTATTRIBSARBPROC)(HDC, HGLRC, const int*);
+typedef BOOL (WINAPI* PFNWGLSWAPINTERVALEXTPROC)(int);
+
 int APIENTRY WinMain(HINSTANCE Instance, HINSTANCE PrevInstance, PSTR CmdLine, int CmdShow)
 {
+    gfx_backend Backend = GFX_BACKEND_COMPAT;
+    if(strstr(CmdLine, "--core"))
+    {
+        Backend = GFX_BACKEND_CORE;
+    }
+
+    b32 VSync = 1;
+    if(strstr(CmdLine, "--no-vsync"))
+    {
+        VSync = 0;
+    }
+
     WNDCLASSEX WindowClassEx = {0};
     WindowClassEx.cbSize = sizeof(WindowClassEx);
     WindowClassEx.style = CS_HREDRAW|CS_VREDRAW|CS_OWNDC;
@@ -79,33 +130,74 @@ int APIENTRY WinMain(HINSTANCE Instance, HINSTANCE PrevInstance, PSTR CmdLine, i
     HGLRC GLRC;
     Assert(GLRC = wglCreateContext(DC));
     Assert(wglMakeCurrent(DC, GLRC));
-    Assert(gfxInit());
+
+    if(Backend == GFX_BACKEND_CORE)
+    {
+        PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribsARB;
+        Assert(wglCreateContextAttribsARB = (PFNWGLCREATECONTEXTATTRIBSARBPROC) wglGetProcAddress("wglCreateContextAttribsARB"));
+
+        int ContextAttributes[] =
+        {
+            WGL_CONTEXT_MAJOR_VERSION_ARB, 3,
+            WGL_CONTEXT_MINOR_VERSION_ARB, 3,
+            WGL_CONTEXT_PROFILE_MASK_ARB, WGL_CONTEXT_CORE_PROFILE_BIT_ARB,
+            0
+        };
+
+        HGLRC CoreGLRC;
+        Assert(CoreGLRC = wglCreateContextAttribsARB(DC, 0, ContextAttributes));
+        Assert(wglMakeCurrent(DC, CoreGLRC));
+        wglDeleteContext(GLRC);
+        GLRC = CoreGLRC;
+    }
+
+    PFNWGLSWAPINTERVALEXTPROC wglSwapIntervalEXT =
+        (PFNWGLSWAPINTERVALEXTPROC) wglGetProcAddress("wglSwapIntervalEXT");
+    if(wglSwapIntervalEXT)
+    {
+        wglSwapIntervalEXT(VSync);
+    }
+    else
+    {
+        gfxDebug("No WGL_EXT_swap_control, vsync is left to the driver\n");
+    }
+
+    Assert(gfxInit(Backend));
 
     gfx_img Img;
     Assert(gfxLoadBmp(&Img, "test.bmp"));
 
-    MSG Msg;
+    // NOTE: Frame scheduler, sleeps until input arrives or a widget asked for a frame
+    DWORD WaitMs = INFINITE;
     b32 OneMoreTime = 0;
-    while(1)
+    b32 ShouldExit = 0;
+    while(!ShouldExit)
     {
-        // TODO: Ideally we want to have some smooth animation?
-        if(!OneMoreTime)
+        if(OneMoreTime)
         {
-            if(GetMessage(&Msg, 0, 0, 0))
-            {
-                TranslateMessage(&Msg);
-                DispatchMessage(&Msg);
+            WaitMs = 0;
+        }
 
-                OneMoreTime = 1;
-            }
-            else
-            {
-                break;
-            }
+        if(WaitMs)
+        {
+            MsgWaitForMultipleObjects(0, 0, FALSE, WaitMs, QS_ALLINPUT);
         }
-        else
+
+        // NOTE: Input is sampled once per frame, so a frame with messages is followed by one more
+        OneMoreTime = 0;
+
+        MSG Msg;
+        while(PeekMessage(&Msg, 0, 0, 0, PM_REMOVE))
         {
-            OneMoreTime = 0;
+            if(Msg.message == WM_QUIT)
+            {
+                ShouldExit = 1;
+            }
+
+            TranslateMessage(&Msg);
+            DispatchMessage(&Msg);
+
+            OneMoreTime = 1;
         }
 
         RECT ClientRect;
@@ -120,14 +212,36 @@ int APIENTRY WinMain(HINSTANCE Instance, HINSTANCE PrevInstance, PSTR CmdLine, i
         GfxCur[1] = (f32) (CursorPos.y);
 
         GfxBtn = GetKeyState(VK_LBUTTON) >> 15;
-        GfxKeyLeft = GetKeyState(VK_LEFT) >> 15;
-        GfxKeyRight = GetKeyState(VK_RIGHT) >> 15;
-        GfxKeyUp = GetKeyState(VK_UP) >> 15;
-        GfxKeyDown = GetKeyState(VK_DOWN) >> 15;
 
+        gfxNewFrame();
+        GFX_TRACE_BEGIN("AppUpdate");
         AppUpdate();
+        GFX_TRACE_END("AppUpdate");
 
+        GfxKeyLeft = 0;
+        GfxKeyRight = 0;
+        GfxKeyUp = 0;
+        GfxKeyDown = 0;
+        GfxKeyShift = 0;
+        GfxWheel = 0;
+
+        u32 FrameWait = gfxFrameWait();
+        WaitMs = (FrameWait == GFX_WAIT_FOREVER) ? INFINITE : FrameWait;
+
+        GFX_TRACE_BEGIN("SwapBuffers");
         Assert(SwapBuffers(DC));
+        GFX_TRACE_END("SwapBuffers");
+    }
+
+    // NOTE: Last 120 frames, see --trace in nix_text.c
+    char* TracePath = strstr(CmdLine, "--trace ");
+    if(TracePath)
+    {
+        char Path[MAX_PATH];
+        if(sscanf(TracePath + 8, "%259s", Path) == 1)
+        {
+            gfxTraceDump(Path, 120);
+        }
     }
 
     return 0;